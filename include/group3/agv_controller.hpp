@@ -0,0 +1,108 @@
+/**
+ * @copyright Copyright (c) 2023
+ * @file agv_controller.hpp
+ * @author Sanchit Kedia (sanchit@terpmail.umd.edu)
+ * @author Adarsh Malapaka (amalapak@terpmail.umd.edu)
+ * @author Tanmay Haldankar (tanmayh@terpmail.umd.edu)
+ * @author Sahruday Patti (sahruday@umd.edu)
+ * @author Kshitij Karnawat (kshitij@umd.edu)
+ * @brief Non-blocking AGV moves for ARIAC 2023 (Group 3)
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ *
+ */
+#pragma once
+#include <array>
+#include <functional>
+#include <future>
+#include <mutex>
+
+#include "dual_arm_executor.hpp"
+
+/**
+ * @brief Class to run AGV moves in the background and track where each AGV is
+ *
+ * A move runs its action (the blocking service calls) on its own thread and hands back a
+ * future of the result, so the caller keeps the robots working and only waits when it needs
+ * a part on the AGV. The AGV's kit tray area is taken before move() returns and held until
+ * the AGV arrives, so a robot action queued after the move never reaches into a moving tray.
+ * An AGV runs one move at a time, a second move of the same AGV waits for the first.
+ */
+class AgvController {
+    public:
+        static constexpr int kAgvs = 4;
+
+        using Action = std::function<bool()>;
+
+        /**
+         * @brief Construct a new AgvController object
+         *
+         * @param reservations Workcell areas shared with the robots
+         */
+        explicit AgvController(WorkspaceReservations& reservations);
+
+        /**
+         * @brief Wait for the moves still running
+         *
+         */
+        ~AgvController();
+
+        AgvController(const AgvController&) = delete;
+        AgvController& operator=(const AgvController&) = delete;
+
+        /**
+         * @brief Start a move
+         *
+         * @param agv AGV (1-4)
+         * @param destination Destination of the move, recorded as the AGV's location when it succeeds
+         * @param action Move, returns false on failure
+         * @return std::shared_future<bool> Result of the move
+         */
+        std::shared_future<bool> move(int agv, int destination, Action action);
+
+        /**
+         * @brief Result of the last move of an AGV, ready and true if it never moved
+         *
+         * @param agv AGV (1-4)
+         */
+        std::shared_future<bool> pending(int agv) const;
+
+        /**
+         * @brief Wait for the last move of an AGV
+         *
+         * @param agv AGV (1-4)
+         * @return bool Result of the move
+         */
+        bool wait(int agv) const { return pending(agv).get(); }
+
+        /**
+         * @brief Destination of the last completed move of an AGV, -1 while it moves or if unknown
+         *
+         * @param agv AGV (1-4)
+         */
+        int location(int agv) const;
+
+        /**
+         * @brief Record where an AGV is without moving it
+         *
+         * @param agv AGV (1-4)
+         * @param destination Location
+         */
+        void set_location(int agv, int destination);
+
+        bool moving(int agv) const;
+
+    private:
+        struct Agv {
+            std::shared_future<bool> last;
+            int location = -1;
+            bool moving = false;
+        };
+
+        void arrive(int agv, int destination, bool moved);
+
+        WorkspaceReservations& reservations_;
+        mutable std::mutex mutex_;
+        std::array<Agv, kAgvs> agvs_;
+};
@@ -18,6 +18,7 @@
 
 #include <array>
 #include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <memory>
 #include <queue>
@@ -31,6 +32,11 @@
 #include <set>
 #include <cmath>
 #include <iterator>
+#include <mutex>
+#include <future>
+#include <list>
+#include <atomic>
+#include <condition_variable>
 
 #include <ament_index_cpp/get_package_share_directory.hpp>
 
@@ -83,6 +89,8 @@
 
 #include <rclcpp/qos.hpp>
 #include <rclcpp/rclcpp.hpp>
+#include <rclcpp/serialization.hpp>
+#include <rclcpp/serialized_message.hpp>
 #include <rclcpp/subscription_options.hpp>
 #include <rclcpp_action/rclcpp_action.hpp>
 #include <rclcpp/time.hpp>
@@ -96,11 +104,24 @@
 #include <geometry_msgs/msg/pose.hpp>
 #include <geometry_msgs/msg/vector3.hpp>
 
+#include "group3/msg/bin_slots.hpp"
 #include "group3/msg/part.hpp"
-#include "group3/msg/parts.hpp"
 
 #include "tray_id_detect.hpp"
 #include "part_type_detect.hpp"
+#include "part_detector.hpp"
+#include "camera_frame_buffer.hpp"
+#include "inventory_readiness.hpp"
+#include "bin_inventory.hpp"
+#include "reservation_ledger.hpp"
+#include "state_journal.hpp"
+#include "kit_tray_model.hpp"
+#include "cell_snapshot.hpp"
+#include "order_queue.hpp"
+#include "order_task.hpp"
+#include "dual_arm_executor.hpp"
+#include "agv_controller.hpp"
+#include "pick_sequencer.hpp"
 #include "map_poses.hpp"
 
 class Orders;
@@ -128,34 +149,36 @@ class AriacCompetition : public rclcpp::Node {
         bool submit_orders_{false};    // Flag to track when to submit orders
         int competition_state_ = -1;  // Competition state
         bool competition_started_{false};   // Flag to check if competition is started
+        bool journal_checked_{false};       // Flag to check if the state journal was matched to the running competition
         int conveyor_size;  // Number of parts spawning on the conveyor 
         bool high_priority_order_{false}; // Flag to check if there is a high priority order
-        bool doing_priority = false;
-        int old_agv;   // AGV that was being used for Combined Order Low Priority
 
-        std::vector<Orders> orders; // Vector of orders
-        std::vector<Orders> incomplete_order; // Vector of incomplete orders
-        std::vector<Orders> current_order; // Vector of current order
+        OrderQueue<Orders> orders; // Orders waiting to be processed, priority orders first
+        std::vector<OrderTask<Orders>> order_tasks_; // Started orders, the last one is active and the ones below it were suspended for a priority order
+        std::list<std::pair<OrderTask<Orders>, std::shared_future<bool>>> finishing_orders_; // Orders waiting on the ceiling robot assembly or the AGV move that ends them, submitted when it completes
 
         std::vector<int> tray_aruco_id;     // Available Trays
         std::vector<int> available_agvs = {1, 2, 3, 4}; // Available AGVs
 
         geometry_msgs::msg::Pose traypartpose; // AGV position
-        std::map<int, geometry_msgs::msg::Pose> partsonkittray; // Map of tray poses
-        struct BinQuadrant {
-            int part_type_clr = -1;
-            geometry_msgs::msg::Pose part_pose;
-        };
-
+        KitTrayModel kit_trays_;           // Parts placed on the kit tray of each AGV
         std::vector<int> conveyor_parts;   // Vector of parts on the conveyor
-        std::map<int, BinQuadrant> bin_map;    // Holds part information in 72 possible bin locations (8 bins x 9 locations)
+        BinInventory bin_map;    // Holds part information in 72 possible bin locations (8 bins x 9 locations)
+        ReservationLedger reservation_ledger_;  // Parts promised to accepted orders
+        PickSequencer pick_sequencer_;          // Pick order of the kit being filled, cached per order
+        StateJournal state_journal_;            // Journal of workcell state changes, open when the state_journal parameter is set
+        CellSnapshot cell_snapshot_;            // Inventory as of the last RefreshCellSnapshot(), guarded by cell_snapshot_mutex_
+        std::mutex cell_snapshot_mutex_;
+        uint64_t cell_snapshot_bins_revision_ = 0;
+        uint64_t cell_snapshot_kit_trays_revision_ = 0;
 
         /**
         * @brief Construct a new Ariac Competition object
         * 
         * @param node_name Name of the node
+        * @param node_options Node options
         */
-        AriacCompetition(std::string);
+        AriacCompetition(std::string, const rclcpp::NodeOptions& node_options = rclcpp::NodeOptions());
         
 
         ////////////////////////////////////////
@@ -182,6 +205,24 @@ class AriacCompetition : public rclcpp::Node {
         */
         void order_callback(const ariac_msgs::msg::Order::SharedPtr);
 
+        /**
+        * @brief Method to build an order from its message, queue it and reserve its parts
+        * 
+        * @param msg Order
+        * @param announced_ns Announcement time in nanoseconds, orders of the same priority are processed in this order
+        * @return true The order was queued
+        * @return false An order with the same ID is already queued
+        */
+        bool QueueOrder(const ariac_msgs::msg::Order& msg, int64_t announced_ns);
+
+        /**
+        * @brief Method to serialize an order for the state journal
+        * 
+        * @param msg Order
+        * @return std::string Serialized message
+        */
+        std::string SerializeOrder(const ariac_msgs::msg::Order& msg);
+
         /**
         * @brief  Callback function to retrieve conveyor part information
         * 
@@ -192,9 +233,25 @@ class AriacCompetition : public rclcpp::Node {
         /**
         * @brief Method to process the order
         * 
+        * Submits the orders the ceiling robot finished assembling. Then starts the next queued
+        * order when no order is active, or suspends the active order when a priority order was
+        * announced after it started. The active order then runs from its last checkpoint until
+        * it is submitted, handed to the ceiling robot for assembly or suspended again. Suspended
+        * orders wait on order_tasks_ instead of the call stack, so nested priority orders do not
+        * recurse.
+        * 
+        * @return true The active order was submitted or handed to the ceiling robot
         */
         bool process_order();
 
+        /**
+        * @brief Method to suspend an order at its last checkpoint if a priority order is waiting
+        * 
+        * @param task Active order
+        * @return true The order was suspended and must return to process_order()
+        */
+        bool SuspendForPriorityOrder(OrderTask<Orders>& task);
+
         /**
         * @brief Method to submit the orders
         * 
@@ -203,48 +260,295 @@ class AriacCompetition : public rclcpp::Node {
         void submit_order(std::string order_id);
 
         /**
-        * @brief Method to do the kitting task
+        * @brief Method to do the kitting task from its last checkpoint
         * 
+        * @param task Active kitting order
+        * @return true The order is complete, false if it was suspended
         */
-        bool do_kitting(std::vector<Orders>);
+        bool do_kitting(OrderTask<Orders>& task);
 
         /**
-        * @brief Method to perform the assembly task
+        * @brief Method to perform the assembly task from its last checkpoint
         * 
+        * @param task Active assembly order
+        * @return true The AGVs are at the station and only the assembly is left, false if it was suspended
         */
-        bool do_assembly(std::vector<Orders>);
+        bool do_assembly(OrderTask<Orders>& task);
 
         /**
-        * @brief Method to carry out the combined task
+        * @brief Method to carry out the combined task from its last checkpoint
         * 
+        * @param task Active combined order
+        * @return true The kit is at the station and only the assembly is left, false if it was suspended
         */
-        bool do_combined(std::vector<Orders>);
+        bool do_combined(OrderTask<Orders>& task);
+
+        /**
+        * @brief Method to pick every part left on the conveyor and place it in the bins, on the floor robot worker
+        * 
+        * Stops with a warning if no part reaches breakbeam_0 within 60 s.
+        */
+        void PickConveyorParts();
+
+        /**
+        * @brief Method to copy the parts still to pass breakbeam_0
+        * 
+        * @return std::vector<int> type*10 + color of each part
+        */
+        std::vector<int> ConveyorParts();
+
+        /**
+        * @brief Method to get the poses of the parts of an order on the AGVs at the assembly station
+        * 
+        * @param order_id Order ID
+        * @return std::vector<ariac_msgs::msg::PartPose> Empty if the service call failed
+        */
+        std::vector<ariac_msgs::msg::PartPose> GetPreAssemblyPoses(const std::string& order_id);
+
+        /**
+        * @brief Method to assemble the parts of an order, the kAssemble stage, run by the ceiling robot worker
+        * 
+        * The ceiling robot waits for the AGVs of the order to reach the station before it picks from them.
+        * 
+        * @param task Assembly or combined order, not touched by the order thread until the assembly ends
+        * @param station_num Assembly station
+        * @param parts Parts of the order in assembly order
+        * @param agv_numbers AGVs carrying the parts
+        * @return true Every part is assembled
+        */
+        bool AssembleOrderParts(OrderTask<Orders>& task, int station_num, const std::vector<Part>& parts, const std::vector<unsigned int>& agv_numbers);
+
+        /**
+        * @brief Method to hand an order whose assembly is left to the ceiling robot
+        * 
+        * The floor robot starts the next order while the ceiling robot assembles this one.
+        * 
+        * @param task Order at the kAssemble stage, moved to finishing_orders_
+        */
+        void StartAssembly(OrderTask<Orders> task);
+
+        /**
+        * @brief Method to place a kit tray on an AGV, on the floor robot worker
+        * 
+        * @param tray_idx Kit tray ID
+        * @param agv_num AGV
+        */
+        void FloorRobotTransferTray(int tray_idx, int agv_num);
+
+        /**
+        * @brief Method to move a bin part to a kit tray quadrant, on the floor robot worker
+        * 
+        * @param quadrant Bin quadrant of the part
+        * @param agv_num AGV carrying the kit tray
+        * @param tray_quadrant Kit tray quadrant
+        * @return true The part was placed
+        */
+        bool FloorRobotTransferBinPart(int quadrant, int agv_num, int tray_quadrant);
+
+        /**
+        * @brief Method to move a bin part out of the floor robot's reach to a kit tray quadrant, on the ceiling robot worker
+        * 
+        * Waits for the ceiling robot to finish the actions queued before it, such as an assembly.
+        * 
+        * @param quadrant Bin quadrant of the part
+        * @param agv_num AGV carrying the kit tray
+        * @param tray_quadrant Kit tray quadrant
+        * @return true The part was placed
+        */
+        bool CeilRobotTransferBinPart(int quadrant, int agv_num, int tray_quadrant);
+
+        /**
+        * @brief Method to move a part from the kit tray of another order to a kit tray quadrant, on the floor robot worker
+        * 
+        * @param tray_cell agv*10 + quadrant of the part to reuse
+        * @param agv_num AGV carrying the kit tray
+        * @param tray_quadrant Kit tray quadrant
+        * @return int type*10 + color of the moved part
+        */
+        int FloorRobotTransferTrayPart(int tray_cell, int agv_num, int tray_quadrant);
+
+        /**
+        * @brief Method to start an AGV move without waiting for it
+        * 
+        * The kit tray model forgets the AGV's tray when the move starts, no robot places on or picks from it again.
+        * 
+        * @param agv_num AGV
+        * @param destination Destination of the move
+        * @param lock Lock the kit tray for the drive and unlock it at the destination
+        * @return std::shared_future<bool> true once the AGV is at the destination
+        */
+        std::shared_future<bool> DispatchAgv(int agv_num, int destination, bool lock);
 
         /**
         * @brief Method to search the bin for the part
         * 
-        * @return int 
+        * Parts are picked from the quadrant closest to the floor robot's current rail position,
+        * preferring quadrants in its workspace. Free quadrants are searched in ascending order.
+        * 
+        * @param part type*10 + color of the part, -1 to find a free quadrant
+        * @return int Quadrant holding the part, -1 if there is none
         */
         int search_bin(int);
 
         /**
-        * @brief Method to check if the conveyor has the part
+        * @brief Method to build the bin pick cost model at the floor robot's current joint state
         * 
-        * @return int 
+        * @return SlotTravelCost 
         */
-        int search_conveyor(int);
+        SlotTravelCost FloorRobotTravelCost();
 
         /**
-        * @brief Set the up map object to store the bin part information
+        * @brief Method to plan the bin picks of a kit, the plan is cached per order and only redone when the bins change under it
         * 
+        * @param order_id Order ID
+        * @param parts type*10 + color of each kit part
+        * @param done Picks of the plan already done
+        * @param agv_num AGV receiving the kit
+        * @return const PickPlan& 
         */
-        void setup_map();
+        const PickPlan& PlanKitPicks(const std::string& order_id, const std::vector<int>& parts, size_t done, int agv_num);
+
+        /**
+        * @brief Method to get the bin slots in the Floor Robot's reachable workspace
+        * 
+        * @return SlotMask 
+        */
+        SlotMask FloorRobotReachableSlots();
+
+        /**
+        * @brief Method to get the parts of an order as type*10 + color keys, one per part
+        * 
+        * @param order Order
+        * @return std::vector<int> 
+        */
+        std::vector<int> OrderPartKeys(const Orders& order);
+
+        /**
+        * @brief Method to reserve the parts of an accepted order against the last cell snapshot
+        * 
+        * Shortages are logged and reserved again when populate_bin_part() refreshes the inventory.
+        * 
+        * @param order_id Order ID
+        * @param priority true for a priority order
+        * @param bill Parts of the order (type*10 + color), one entry per part
+        */
+        void ReserveOrderParts(const std::string& order_id, bool priority, const std::vector<int>& bill);
+
+        /**
+        * @brief Method to mark a bin part as picked for the current order
+        * 
+        * @param quadrant Quadrant the part was picked from
+        */
+        void ConsumeBinPart(int quadrant);
+
+        /**
+        * @brief Method to set or clear the part of a bin quadrant and journal the change
+        * 
+        * @param quadrant Quadrant (1-72)
+        * @param part_type_clr type*10 + color of the part, -1 to clear the quadrant
+        */
+        void UpdateBinPart(int quadrant, int part_type_clr);
+
+        /**
+        * @brief Method to set the part of a bin quadrant at a measured pose and journal the change
+        * 
+        * @param quadrant Quadrant (1-72)
+        * @param part_type_clr type*10 + color of the part
+        * @param pose Pose of the part
+        */
+        void UpdateBinPart(int quadrant, int part_type_clr, const geometry_msgs::msg::Pose& pose);
+
+        /**
+        * @brief Method to copy a bin camera detection into the bin map, slots seen empty are cleared
+        * 
+        * @param slots Detection of one bin camera, ignored if nullptr
+        * @return int Number of occupied slots copied
+        */
+        int CopyBinSlots(const group3::msg::BinSlots::ConstSharedPtr& slots);
+
+        /**
+        * @brief Method to record a part placed on a kit tray for the current order in kit_trays_ and the journal
+        * 
+        * @param agv_num AGV carrying the kit tray
+        * @param quadrant Kit tray quadrant
+        * @param part_type_clr type*10 + color of the part
+        */
+        void RecordKitTrayPart(int agv_num, int quadrant, int part_type_clr);
+
+        /**
+        * @brief Method to pick a part placed on the kit tray of another order for reuse by the current order
+        * 
+        * @param tray_cell agv*10 + quadrant of the kit tray part
+        * @return int type*10 + color of the picked part
+        */
+        int PickKitTrayPart(int tray_cell);
+
+        /**
+        * @brief Method to record the quality check result of the parts on a kit tray
+        * 
+        * @param agv_num AGV carrying the kit tray
+        * @param quality_check Result of CheckFaultyPart()
+        */
+        void RecordKitTrayQuality(int agv_num, const std::vector<bool>& quality_check);
+
+        /**
+        * @brief Method to take a new cell snapshot and log the slots that changed since the previous one
+        * 
+        * Areas that did not change are shared with the previous snapshot instead of copied.
+        * 
+        * @return CellSnapshot
+        */
+        CellSnapshot RefreshCellSnapshot();
+
+        /**
+        * @brief Method to get the last cell snapshot, safe to call from any thread
+        * 
+        * @return CellSnapshot
+        */
+        CellSnapshot CurrentCellSnapshot();
+
+        /**
+        * @brief Method to restore bin parts, kit tray parts, AGVs, the conveyor and the unsubmitted orders from the state journal
+        * 
+        */
+        void RestoreJournalState();
+
+        /**
+        * @brief Method to match the state journal to the running competition, once
+        * 
+        * A competition started by this node is a new trial and the journal of an earlier run is
+        * discarded. Otherwise the node restarted during a trial and the journal is restored if it
+        * was stamped with a start time before the current time, and discarded if not.
+        * 
+        * @param new_competition true when this node is starting the competition
+        */
+        void CheckJournalCompetition(bool new_competition);
+
+        /**
+        * @brief Method to check if the conveyor has the part
+        * 
+        * @return int 
+        */
+        int search_conveyor(int);
 
         /**
          * @brief Method to populate the bin_map using RGB image information
          * 
+         * Blocks until both bin part detectors have reported a detection made from an image
+         * newer than the given stamps. Waits at most 1 s for fresh detections and 10 s for the
+         * first ones, then warns and uses whatever was detected. Shortages of accepted orders are
+         * reserved again against the refreshed inventory.
+         * 
+         * @param newer_than Bin camera image stamps the detections must be newer than, -1 for any detection
+         */
+        void populate_bin_part(const InventoryReadiness::Stamps& newer_than = {-1, -1});
+
+        /**
+         * @brief Stamps of the latest right and left bins camera images
+         * 
+         * @return InventoryReadiness::Stamps 
          */
-        void populate_bin_part();
+        InventoryReadiness::Stamps bin_camera_stamps();
 
         ////////////////////////////////////////
         //        Type Conversion Methods
@@ -303,9 +607,9 @@ class AriacCompetition : public rclcpp::Node {
         * 
         * @param int  AGV number
         * @param std::string AGV Destination
-        *
+        * @return true The AGV reached the destination
         */
-        void move_agv(int, int);
+        bool move_agv(int, int);
 
         /**
         * @brief Method to choose the AGV for Combined task
@@ -394,8 +698,8 @@ class AriacCompetition : public rclcpp::Node {
          * 
          * @param agv_num AGV number
          * @param quadrant Tray quadrant
-         * @return true 
-         * @return false 
+         * @return true The part was left on the tray
+         * @return false The part failed the quality check and was disposed of
          */
         bool FloorRobotPlacePartOnKitTray(int agv_num, int quadrant);
 
@@ -443,8 +747,8 @@ class AriacCompetition : public rclcpp::Node {
          * 
          * @param agv_num AGV number
          * @param quadrant Tray quadrant
-         * @return true 
-         * @return false 
+         * @return true The part was left on the tray
+         * @return false The part failed the quality check and was disposed of
          */
         bool CeilRobotPlacePartOnKitTray(int agv_num, int quadrant);
 
@@ -652,6 +956,18 @@ class AriacCompetition : public rclcpp::Node {
          * @param model_pose Model pose
          */
         void AddModelToPlanningScene(std::string name, std::string mesh_file, geometry_msgs::msg::Pose model_pose);
+
+        /**
+         * @brief Method to name the planning scene object of a part held by a robot
+         * 
+         * Each robot has its own prefix, so both can hold a part of the same type and color at once.
+         * 
+         * @param robot "floor" or "ceiling"
+         * @param part_clr Color of the part
+         * @param part_type Type of the part
+         * @return std::string 
+         */
+        std::string PlanningScenePartName(const std::string& robot, int part_clr, int part_type);
         
         /**
          * @brief Method to add competition models to RViz Planning Scene
@@ -670,6 +986,8 @@ class AriacCompetition : public rclcpp::Node {
         moveit::planning_interface::MoveGroupInterfacePtr floor_robot_;
         moveit::planning_interface::MoveGroupInterfacePtr ceil_robot_;
         moveit::planning_interface::PlanningSceneInterface planning_scene_;
+        DualArmExecutor arms_;   // Floor and ceiling robot workers, declared after the robots so it stops first
+        AgvController agvs_{arms_.reservations()};  // AGV moves in flight, declared after arms_ as it holds areas in its reservations
         
         trajectory_processing::TimeOptimalTrajectoryGeneration totg_;
 
@@ -706,8 +1024,8 @@ class AriacCompetition : public rclcpp::Node {
         rclcpp::Subscription<ariac_msgs::msg::BreakBeamStatus>::SharedPtr breakbeam2_sub_;
 
         // OpenCV detection subscriptions
-        rclcpp::Subscription<group3::msg::Parts>::SharedPtr right_part_detector_sub_;
-        rclcpp::Subscription<group3::msg::Parts>::SharedPtr left_part_detector_sub_;
+        rclcpp::Subscription<group3::msg::BinSlots>::SharedPtr right_part_detector_sub_;
+        rclcpp::Subscription<group3::msg::BinSlots>::SharedPtr left_part_detector_sub_;
         rclcpp::Subscription<group3::msg::Part>::SharedPtr conv_part_detector_sub_;
 
         // Assembly State subscriptions
@@ -716,20 +1034,26 @@ class AriacCompetition : public rclcpp::Node {
         rclcpp::Subscription<ariac_msgs::msg::AssemblyState>::SharedPtr as3_state_sub_;
         rclcpp::Subscription<ariac_msgs::msg::AssemblyState>::SharedPtr as4_state_sub_;
 
-        // Break Beam variables
-        bool breakbeam_status;
-        bool breakbeam_trigger;
-        bool breakbeam1_status;
-        bool breakbeam2_status;
+        // Break Beam variables, the statuses are written by the sensor callbacks and waited on by the floor robot worker
+        std::atomic<bool> breakbeam_status{false};
+        bool breakbeam_trigger{false};
+        std::atomic<bool> breakbeam1_status{false};
+        std::atomic<bool> breakbeam2_status{false};
         float breakbeam_time_sec;
+        std::mutex conveyor_mutex_;            // Guards conv_parts_, conv_camera_pose_, conv_rgb_parts_ and conveyor_parts
+        std::condition_variable conveyor_cv_;  // Signalled by breakbeam_0 and breakbeam_2
         bool wait_flag = false;
         
         // Sensor Images
-        cv::Mat kts1_rgb_camera_image_;
-        cv::Mat kts2_rgb_camera_image_;
-        cv::Mat left_bins_rgb_camera_image_;
-        cv::Mat right_bins_rgb_camera_image_;
-        cv::Mat conv_rgb_camera_image_;
+        // Latest frame of every RGB camera, read only by the order processing thread
+        CameraFrameBuffer kts1_rgb_camera_frame_;
+        CameraFrameBuffer kts2_rgb_camera_frame_;
+        CameraFrameBuffer left_bins_rgb_camera_frame_;
+        CameraFrameBuffer right_bins_rgb_camera_frame_;
+
+        // Tray detectors, one per kitting tray station camera
+        TrayDetector kts1_tray_detector_;
+        TrayDetector kts2_tray_detector_;
 
         // Sensor poses
         geometry_msgs::msg::Pose conv_camera_pose_;
@@ -738,9 +1062,6 @@ class AriacCompetition : public rclcpp::Node {
         std::vector<geometry_msgs::msg::Pose> left_bins_parts_;
         std::vector<geometry_msgs::msg::Pose> right_bins_parts_;
 
-        //Quadrants
-        std::vector<int> occupied_quadrants;
-
         // Callback Groups
         rclcpp::CallbackGroup::SharedPtr order_cb_group_;
         rclcpp::CallbackGroup::SharedPtr topic_cb_group_;
@@ -753,8 +1074,10 @@ class AriacCompetition : public rclcpp::Node {
         ariac_msgs::msg::Part ceil_robot_attached_part_;
 
         // Parts
-        std::vector<group3::msg::Part> right_parts_;
-        std::vector<group3::msg::Part> left_parts_;
+        std::mutex bin_parts_mutex_;    // Guards right_slots_ and left_slots_
+        group3::msg::BinSlots::ConstSharedPtr right_slots_;  // Latest right bins detection, nullptr before the first one
+        group3::msg::BinSlots::ConstSharedPtr left_slots_;   // Latest left bins detection, nullptr before the first one
+        InventoryReadiness inventory_readiness_;  // Signalled by the bin part detector callbacks
         std::vector<ariac_msgs::msg::Part> dropped_parts_;
         std::vector<geometry_msgs::msg::Pose> conv_parts_;
         group3::msg::Part pump_rgb;
@@ -798,8 +1121,8 @@ class AriacCompetition : public rclcpp::Node {
         void floor_gripper_state_cb(const ariac_msgs::msg::VacuumGripperState::ConstSharedPtr msg);
         void ceil_gripper_state_cb(const ariac_msgs::msg::VacuumGripperState::ConstSharedPtr msg);
         
-        void right_part_detector_cb(const group3::msg::Parts::ConstSharedPtr msg);
-        void left_part_detector_cb(const group3::msg::Parts::ConstSharedPtr msg);
+        void right_part_detector_cb(const group3::msg::BinSlots::ConstSharedPtr msg);
+        void left_part_detector_cb(const group3::msg::BinSlots::ConstSharedPtr msg);
         void conv_part_detector_cb(const group3::msg::Part::ConstSharedPtr msg);
 
         void as1_state_cb(const ariac_msgs::msg::AssemblyState::ConstSharedPtr msg);
@@ -813,8 +1136,6 @@ class AriacCompetition : public rclcpp::Node {
         double pick_offset_ = 0.003;
         double battery_grip_offset_ = -0.05;
 
-        std::map<int, geometry_msgs::msg::Pose> bin_quadrant_poses;
-        std::map<int, geometry_msgs::msg::Pose> tray_poses;
 
         std::map<int, std::string> part_types_ = {
             {ariac_msgs::msg::Part::BATTERY, "battery"},
@@ -1254,10 +1575,14 @@ class Orders {
         */
         Orders(std::string id,
                 unsigned int type,
-                bool priority) : id_(id),
+                bool priority) : id_(std::move(id)),
                                     type_(type),
                                     priority_(priority) {}
         ~Orders() = default;
+        Orders(const Orders&) = default;
+        Orders& operator=(const Orders&) = default;
+        Orders(Orders&&) = default;
+        Orders& operator=(Orders&&) = default;
         
         /**
         * @brief Get the Id object
@@ -1293,7 +1618,7 @@ class Orders {
         * 
         * @param _kitting 
         */
-        virtual void SetKitting(std::shared_ptr<Kitting> _kitting) { kitting_ = _kitting; }
+        virtual void SetKitting(std::shared_ptr<Kitting> _kitting) { kitting_ = std::move(_kitting); }
 
         /**
         * @brief Get the Assembly object
@@ -1307,7 +1632,7 @@ class Orders {
         * 
         * @param _assembly 
         */
-        virtual void SetAssembly(std::shared_ptr<Assembly> _assembly) { assembly_ = _assembly; }
+        virtual void SetAssembly(std::shared_ptr<Assembly> _assembly) { assembly_ = std::move(_assembly); }
 
         /**
         * @brief Get the Combined object
@@ -1321,6 +1646,6 @@ class Orders {
         * 
         * @param _combined 
         */
-        virtual void SetCombined(std::shared_ptr<Combined> _combined) { combined_ = _combined; }
+        virtual void SetCombined(std::shared_ptr<Combined> _combined) { combined_ = std::move(_combined); }
 
 };
@@ -0,0 +1,212 @@
+/**
+ * @copyright Copyright (c) 2023
+ * @file bin_grid_detector.hpp
+ * @author Sanchit Kedia (sanchit@terpmail.umd.edu)
+ * @author Adarsh Malapaka (amalapak@terpmail.umd.edu)
+ * @author Tanmay Haldankar (tanmayh@terpmail.umd.edu)
+ * @author Sahruday Patti (sahruday@umd.edu)
+ * @author Kshitij Karnawat (kshitij@umd.edu)
+ * @brief Table driven bin part detector for ARIAC 2023 (Group 3)
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ *
+ */
+#pragma once
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief One bin as seen by a bin camera
+ *
+ */
+struct BinLayout {
+    int camera;      // Index of the camera frame passed to BinGridDetector::detect()
+    cv::Rect roi;    // Bin region in the camera image
+    int first_slot;  // bin_map quadrant (1-72) of the first slot of the bin
+};
+
+/**
+ * @brief Layout of the four bins seen by the right bins camera (quadrants 1-36)
+ *
+ * @param camera Camera index to assign to the bins
+ * @return std::vector<BinLayout>
+ */
+std::vector<BinLayout> right_bins_layout(int camera = 0);
+
+/**
+ * @brief Layout of the four bins seen by the left bins camera (quadrants 37-72)
+ *
+ * @param camera Camera index to assign to the bins
+ * @return std::vector<BinLayout>
+ */
+std::vector<BinLayout> left_bins_layout(int camera = 0);
+
+/**
+ * @brief Parts of every slot of a layout table, in quadrant order from the first slot of the table
+ *
+ * Fixed size, so a detection fills it without allocating and it can be copied as is into a
+ * group3::msg::BinSlots message.
+ */
+struct BinSlotDetections {
+    static constexpr int kMaxSlots = 36;     // Four bins of nine slots
+    static constexpr uint8_t kEmpty = 0xFF;
+
+    int first_quadrant = 1;                      // Quadrant (1-72) of slot 0
+    uint64_t occupied = 0;                       // Bit i is set when slot i holds a part
+    std::array<uint8_t, kMaxSlots> part;         // type*10 + color of slot i, kEmpty if none
+    std::array<uint8_t, kMaxSlots> confidence;   // Share of the part's foreground pixels with its color, 0-255
+};
+
+/**
+ * @brief Class to detect the parts in the 3x3 slot grid of every bin of a camera layout table
+ *
+ * All intermediate images are allocated once per bin in the constructor and reused on every
+ * frame, and the slot of a part centroid is read from a precomputed per-pixel slot map. In
+ * parallel mode the bins are processed concurrently with cv::parallel_for_, each bin using its
+ * own buffers. In incremental mode the detector keeps, for every slot, the frame it was last
+ * classified on and only reclassifies the slots whose mean absolute pixel difference from it
+ * exceeds a threshold, the other slots keep their cached parts. An instance is not reentrant: use one detector per
+ * thread.
+ */
+class BinGridDetector {
+    public:
+        /**
+         * @brief Called for every part contour a detection classifies
+         *
+         * Arguments: bin index in the layout table, quadrant (1-72), color labels and foreground mask of
+         * the bin image, contour in bin image coordinates. The images are the detector's buffers and are
+         * only valid during the call.
+         */
+        using ContourCallback = std::function<void(size_t, int, const cv::Mat&, const cv::Mat&, const std::vector<cv::Point>&)>;
+
+        /**
+         * @brief Construct a new Bin Grid Detector object
+         *
+         * @param layout Camera to bin layout table
+         * @param parallel Process the bins concurrently
+         * @param incremental Reclassify only the slots that changed since the previous frame
+         */
+        explicit BinGridDetector(std::vector<BinLayout> layout, bool parallel = false, bool incremental = false);
+
+        /**
+         * @brief Method to detect the parts in all the bins of the layout
+         *
+         * @param frames Camera images (BGR), indexed by BinLayout::camera
+         * @return std::vector<std::vector<int>> {color, type, quadrant} of every detected part, sorted by quadrant
+         */
+        std::vector<std::vector<int>> detect(const std::vector<cv::Mat>& frames);
+
+        /**
+         * @brief Method to detect the parts in all the bins of the layout into a fixed slot table
+         *
+         * Slots outside the first BinSlotDetections::kMaxSlots quadrants of the layout are dropped.
+         *
+         * @param frames Camera images (BGR), indexed by BinLayout::camera
+         * @param slots Filled with the parts of every slot
+         */
+        void detect(const std::vector<cv::Mat>& frames, BinSlotDetections& slots);
+
+        /**
+         * @brief Enable or disable processing the bins concurrently
+         *
+         * @param parallel Process the bins concurrently
+         */
+        void set_parallel(bool parallel) { parallel_ = parallel; }
+
+        /**
+         * @brief Enable or disable reclassifying only the slots that changed
+         *
+         * @param incremental Reclassify only the slots that changed since the previous frame
+         */
+        void set_incremental(bool incremental) { incremental_ = incremental; }
+
+        /**
+         * @brief Set a callback run on every part contour before it is classified, for benchmarks and debugging
+         *
+         * In parallel mode the callback runs concurrently for different bins.
+         *
+         * @param callback Callback, an empty function disables it
+         */
+        void set_contour_callback(ContourCallback callback) { contour_callback_ = std::move(callback); }
+
+        /**
+         * @brief Drop the previous frames and cached parts, the next frame is fully reclassified
+         *
+         */
+        void reset();
+
+        /**
+         * @brief Method to return the quadrant of a point of a bin image
+         *
+         * @param bin Index of the bin in the layout table
+         * @param p Point in bin image coordinates
+         * @return int Quadrant (1-72), -1 if the point is between two slots
+         */
+        int slot_at(size_t bin, cv::Point p) const;
+
+        /**
+         * @brief Get the layout table
+         *
+         * @return const std::vector<BinLayout>&
+         */
+        const std::vector<BinLayout>& layout() const { return layout_; }
+
+    private:
+        /**
+         * @brief Buffers reused for one bin across frames
+         *
+         */
+        struct BinBuffers {
+            cv::Mat slot_map;  // Slot number (1-9) of every pixel, 0 between slots
+            std::array<cv::Rect, 9> cells;  // Slot cells, in slot order
+            cv::Mat previous;  // Bin image, each slot cell as of the frame it was last classified on
+            bool has_previous = false;
+            cv::Mat mask;
+            cv::Mat morph;
+            cv::Mat labels;
+            cv::Mat blur;
+            std::vector<std::vector<cv::Point>> contours;
+            std::vector<cv::Vec4i> hierarchy;
+            std::array<uint8_t, 9> part;        // type*10 + color detected in each slot, BinSlotDetections::kEmpty if none
+            std::array<uint8_t, 9> confidence;  // Confidence of each slot's part
+        };
+
+        /**
+         * @brief Method to detect the parts in one bin
+         *
+         * @param bin Index of the bin in the layout table
+         * @param frame Camera image containing the bin
+         */
+        void detect_bin(size_t bin, const cv::Mat& frame);
+
+        /**
+         * @brief Method to run detect_bin() on every bin of the layout
+         *
+         * @param frames Camera images (BGR), indexed by BinLayout::camera
+         */
+        void detect_bins(const std::vector<cv::Mat>& frames);
+
+        /**
+         * @brief Share of the foreground pixels in a part's bounding box that carry the part's color
+         *
+         * @param buf Buffers of the bin
+         * @param box Bounding box of the part in bin image coordinates
+         * @param color Color of the part
+         * @return uint8_t Confidence, 0-255
+         */
+        static uint8_t color_confidence(const BinBuffers& buf, const cv::Rect& box, int color);
+
+        std::vector<BinLayout> layout_;
+        std::vector<BinBuffers> buffers_;
+        cv::Mat element_;
+        bool parallel_;
+        bool incremental_;
+        ContourCallback contour_callback_;
+};
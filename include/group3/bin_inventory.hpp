@@ -0,0 +1,180 @@
+/**
+ * @copyright Copyright (c) 2023
+ * @file bin_inventory.hpp
+ * @author Sanchit Kedia (sanchit@terpmail.umd.edu)
+ * @author Adarsh Malapaka (amalapak@terpmail.umd.edu)
+ * @author Tanmay Haldankar (tanmayh@terpmail.umd.edu)
+ * @author Sahruday Patti (sahruday@umd.edu)
+ * @author Kshitij Karnawat (kshitij@umd.edu)
+ * @brief Indexed bin part inventory for ARIAC 2023 (Group 3)
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ *
+ */
+#pragma once
+#include <cmath>
+
+#include <geometry_msgs/msg/pose.hpp>
+
+#include "bin_slot_table.hpp"
+#include "slot_allocator.hpp"
+
+/**
+ * @brief Part held by one bin quadrant
+ *
+ */
+struct BinQuadrant {
+    int part_type_clr = -1;             // type*10 + color, -1 if the quadrant is free
+    geometry_msgs::msg::Pose part_pose;
+};
+
+/**
+ * @brief Estimated cost of picking from each bin slot with the floor robot at a rail position
+ *
+ * The floor robot picks from a fixed rail position per bin side, so the travel part of the
+ * cost is the rail distance to that side. Slots outside the floor robot's workspace are
+ * picked by the ceiling robot and carry a flat penalty, larger than crossing the rail, so a
+ * floor reachable part on the far side wins over a ceiling only part on the near side.
+ */
+struct SlotTravelCost {
+    double rail_position = 0.0;     // Current linear_actuator_joint position
+    double right_bins_rail = -3.0;  // Rail position for slots 0-35 (quadrants 1-36)
+    double left_bins_rail = 3.0;    // Rail position for slots 36-71 (quadrants 37-72)
+    double ceiling_penalty = 10.0;  // Added to slots the floor robot can not reach
+    SlotMask floor_reachable;       // Slots in the floor robot's workspace
+
+    /**
+     * @brief Cost of picking from a slot
+     *
+     * @param slot Slot (quadrant - 1)
+     * @return double
+     */
+    double operator()(int slot) const {
+        double rail = slot < BinSlotTable::kSlots / 2 ? right_bins_rail : left_bins_rail;
+        double cost = std::abs(rail_position - rail);
+        return floor_reachable.test(slot) ? cost : cost + ceiling_penalty;
+    }
+};
+
+/**
+ * @brief Bin quadrants (1-72) stored in a BinSlotTable
+ *
+ * Every write goes through set() or clear(), which keep the part byte, the occupancy mask and
+ * the part type/color masks of the table in step, so a lookup never scans the bins. They also
+ * take slots from and give them back to the SlotAllocator used to place conveyor parts.
+ */
+class BinInventory {
+    public:
+        static constexpr int kQuadrants = BinSlotTable::kSlots;  // 8 bins x 9 quadrants
+
+        /**
+         * @brief Construct an inventory with every quadrant free
+         *
+         */
+        BinInventory();
+
+        /**
+         * @brief Put a part in a quadrant, replacing the part it held
+         *
+         * Parts whose type or color is unknown are stored but can not be searched.
+         *
+         * @param quadrant Quadrant (1-72)
+         * @param part_type_clr type*10 + color of the part
+         * @param pose Pose of the part
+         */
+        void set(int quadrant, int part_type_clr, const geometry_msgs::msg::Pose& pose);
+
+        /**
+         * @brief Mark a quadrant as free, the pose is kept. Unknown quadrants are ignored
+         *
+         * @param quadrant Quadrant (1-72)
+         */
+        void clear(int quadrant);
+
+        /**
+         * @brief First quadrant holding the part, -1 finds a free quadrant
+         *
+         * @param part_type_clr type*10 + color of the part, or -1
+         * @return int Lowest matching quadrant, -1 if there is none
+         */
+        int find(int part_type_clr) const;
+
+        /**
+         * @brief Quadrant holding the part with the lowest pick cost
+         *
+         * Ties go to the lowest quadrant, so with a flat cost this is find().
+         *
+         * @param part_type_clr type*10 + color of the part
+         * @param cost Cost model at the current robot position
+         * @param excluded Slots not to pick from, such as slots reserved by other orders
+         * @return int Cheapest matching quadrant, -1 if there is none
+         */
+        int nearest(int part_type_clr, const SlotTravelCost& cost, const SlotMask& excluded = SlotMask()) const;
+
+        /**
+         * @brief All slots holding the part, -1 gives the free slots
+         *
+         * @param part_type_clr type*10 + color of the part, or -1
+         * @return SlotMask Matching slots (quadrant - 1)
+         */
+        SlotMask candidates(int part_type_clr) const;
+
+        /**
+         * @brief Set the slots the floor robot can reach, the only ones allocate() hands out
+         *
+         * @param floor_reachable Slots in the floor robot's workspace
+         */
+        void set_floor_reachable(const SlotMask& floor_reachable) { allocator_.set_floor_reachable(floor_reachable); }
+
+        /**
+         * @brief Take a free floor reachable quadrant to drop a part in, on the bin side closest to the robot
+         *
+         * The quadrant stays taken until a part seen in it is picked and cleared.
+         *
+         * @param cost Cost model at the current robot position
+         * @return int Quadrant, -1 if no floor reachable quadrant is free
+         */
+        int allocate(const SlotTravelCost& cost);
+
+        /**
+         * @brief Take a quadrant allocate() handed out before a restart, until a part seen in it is picked and cleared
+         *
+         * @param quadrant Quadrant (1-72)
+         */
+        void claim(int quadrant) { allocator_.occupy(quadrant - 1); }
+
+        /**
+         * @brief Number of occupied quadrants
+         *
+         * @return int
+         */
+        int occupied_count() const { return table_.occupied.count(); }
+
+        /**
+         * @brief Part held by a quadrant, a free quadrant if it does not exist
+         *
+         * @param quadrant Quadrant (1-72)
+         * @return BinQuadrant
+         */
+        BinQuadrant operator[](int quadrant) const;
+
+        /**
+         * @brief Copy of the slot table, for planning without touching the inventory
+         *
+         * @return BinSlotTable
+         */
+        BinSlotTable snapshot() const { return table_; }
+
+        /**
+         * @brief Counter bumped by every set() and clear() that changes the table
+         *
+         * @return uint64_t
+         */
+        uint64_t revision() const { return revision_; }
+
+    private:
+        BinSlotTable table_;
+        uint64_t revision_ = 0;
+        SlotAllocator allocator_;
+};
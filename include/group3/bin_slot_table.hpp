@@ -0,0 +1,166 @@
+/**
+ * @copyright Copyright (c) 2023
+ * @file bin_slot_table.hpp
+ * @author Sanchit Kedia (sanchit@terpmail.umd.edu)
+ * @author Adarsh Malapaka (amalapak@terpmail.umd.edu)
+ * @author Tanmay Haldankar (tanmayh@terpmail.umd.edu)
+ * @author Sahruday Patti (sahruday@umd.edu)
+ * @author Kshitij Karnawat (kshitij@umd.edu)
+ * @brief Fixed size bin slot table for ARIAC 2023 (Group 3)
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ *
+ */
+#pragma once
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+#include <ariac_msgs/msg/part.hpp>
+#include <geometry_msgs/msg/pose.hpp>
+
+/**
+ * @brief Set of bin slots (0-71) stored as a 128 bit mask
+ *
+ */
+struct SlotMask {
+    std::array<uint64_t, 2> words{};
+
+    void set(int slot) { words[slot >> 6] |= uint64_t{1} << (slot & 63); }
+    void reset(int slot) { words[slot >> 6] &= ~(uint64_t{1} << (slot & 63)); }
+    bool test(int slot) const { return (words[slot >> 6] >> (slot & 63)) & 1; }
+    bool any() const { return (words[0] | words[1]) != 0; }
+    int count() const { return __builtin_popcountll(words[0]) + __builtin_popcountll(words[1]); }
+
+    /**
+     * @brief Lowest slot in the set
+     *
+     * @return int Slot, -1 if the set is empty
+     */
+    int first() const {
+        if (words[0]) {
+            return __builtin_ctzll(words[0]);
+        }
+        if (words[1]) {
+            return 64 + __builtin_ctzll(words[1]);
+        }
+        return -1;
+    }
+
+    /**
+     * @brief Call fn for every slot in the set in ascending order
+     *
+     */
+    template <typename Fn>
+    void for_each(Fn fn) const {
+        for (int w = 0; w < 2; w++) {
+            for (uint64_t bits = words[w]; bits; bits &= bits - 1) {
+                fn(w * 64 + __builtin_ctzll(bits));
+            }
+        }
+    }
+
+    SlotMask operator&(const SlotMask& other) const { return {{words[0] & other.words[0], words[1] & other.words[1]}}; }
+    SlotMask operator|(const SlotMask& other) const { return {{words[0] | other.words[0], words[1] | other.words[1]}}; }
+    SlotMask without(const SlotMask& other) const { return {{words[0] & ~other.words[0], words[1] & ~other.words[1]}}; }
+    SlotMask& operator|=(const SlotMask& other) {
+        words[0] |= other.words[0];
+        words[1] |= other.words[1];
+        return *this;
+    }
+};
+
+/**
+ * @brief Pose of a slot without the message allocator, so the table stays trivially copyable
+ *
+ */
+struct SlotPose {
+    double px, py, pz;
+    double qx, qy, qz, qw;
+
+    static SlotPose from_msg(const geometry_msgs::msg::Pose& pose) {
+        return {pose.position.x, pose.position.y, pose.position.z,
+                pose.orientation.x, pose.orientation.y, pose.orientation.z, pose.orientation.w};
+    }
+
+    geometry_msgs::msg::Pose to_msg() const {
+        geometry_msgs::msg::Pose pose;
+        pose.position.x = px;
+        pose.position.y = py;
+        pose.position.z = pz;
+        pose.orientation.x = qx;
+        pose.orientation.y = qy;
+        pose.orientation.z = qz;
+        pose.orientation.w = qw;
+        return pose;
+    }
+};
+
+/**
+ * @brief Structure of arrays holding the 72 bin slots (8 bins x 9 slots)
+ *
+ * Slot s is bin quadrant s + 1. Each slot stores its part as one byte (type*10 + color,
+ * kEmpty if free) and its pose in a separate array. Occupancy and one mask per part
+ * type/color turn searches and counts into bit operations. The table is trivially copyable,
+ * so a plain copy is a consistent snapshot.
+ */
+struct BinSlotTable {
+    static constexpr int kSlots = 72;
+    static constexpr uint8_t kEmpty = 0xFF;
+    static constexpr int kFirstType = ariac_msgs::msg::Part::BATTERY;
+    static constexpr int kTypes = 4;   // Battery, pump, sensor, regulator
+    static constexpr int kColors = 5;  // Red, green, blue, orange, purple
+
+    std::array<uint8_t, kSlots> part;           // type*10 + color, kEmpty if free
+    std::array<SlotPose, kSlots> pose;
+    SlotMask occupied;
+    std::array<SlotMask, kTypes * kColors> by_part;  // Slots holding each type/color
+
+    /**
+     * @brief Index of a part type/color in by_part
+     *
+     * @param part_type_clr type*10 + color
+     * @return int Index, -1 if the type or color is unknown
+     */
+    static int part_index(int part_type_clr) {
+        int type = part_type_clr / 10 - kFirstType;
+        int color = part_type_clr % 10;
+        if (part_type_clr < 0 || type < 0 || type >= kTypes || color >= kColors) {
+            return -1;
+        }
+        return type * kColors + color;
+    }
+
+    /**
+     * @brief Set of free slots
+     *
+     * @return SlotMask
+     */
+    SlotMask free() const {
+        SlotMask mask;
+        mask.words[0] = ~occupied.words[0];
+        mask.words[1] = ~occupied.words[1] & ((uint64_t{1} << (kSlots - 64)) - 1);
+        return mask;
+    }
+
+    /**
+     * @brief Slots holding any color of a part type
+     *
+     * @param type Part type (ariac_msgs::msg::Part)
+     * @return SlotMask
+     */
+    SlotMask of_type(int type) const {
+        SlotMask mask;
+        int t = type - kFirstType;
+        if (t < 0 || t >= kTypes) {
+            return mask;
+        }
+        for (int color = 0; color < kColors; color++) {
+            mask |= by_part[t * kColors + color];
+        }
+        return mask;
+    }
+};
+
+static_assert(std::is_trivially_copyable<BinSlotTable>::value, "BinSlotTable is copied as a snapshot");
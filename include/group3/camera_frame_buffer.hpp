@@ -0,0 +1,141 @@
+/**
+ * @copyright Copyright (c) 2023
+ * @file camera_frame_buffer.hpp
+ * @author Sanchit Kedia (sanchit@terpmail.umd.edu)
+ * @author Adarsh Malapaka (amalapak@terpmail.umd.edu)
+ * @author Tanmay Haldankar (tanmayh@terpmail.umd.edu)
+ * @author Sahruday Patti (sahruday@umd.edu)
+ * @author Kshitij Karnawat (kshitij@umd.edu)
+ * @brief Lock-free latest camera frame buffer for ARIAC 2023 (Group 3)
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ *
+ */
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include <opencv2/core.hpp>
+#include <rclcpp/time.hpp>
+#include <sensor_msgs/msg/image.hpp>
+#include "cv_bridge/cv_bridge.h"
+
+/**
+ * @brief Single producer, single consumer triple buffer
+ *
+ * The producer fills the back slot and publishes it by swapping it with the middle slot. The
+ * consumer swaps the middle slot into the front slot when a new value was published. Neither
+ * side ever waits or sees a slot that the other side is writing.
+ *
+ * @tparam T Slot type
+ */
+template <typename T>
+class TripleBuffer {
+    public:
+        /**
+         * @brief Slot the producer may write, published by publish()
+         *
+         * @return T&
+         */
+        T& write_buffer() { return slots_[back_]; }
+
+        /**
+         * @brief Publish the write buffer as the latest value
+         *
+         */
+        void publish() {
+            uint8_t previous = middle_.exchange(back_ | kDirty, std::memory_order_acq_rel);
+            back_ = previous & kIndexMask;
+        }
+
+        /**
+         * @brief Make the latest published value the read buffer
+         *
+         * @return true A new value was published since the last call
+         */
+        bool update() {
+            if (!(middle_.load(std::memory_order_relaxed) & kDirty)) {
+                return false;
+            }
+            uint8_t previous = middle_.exchange(front_, std::memory_order_acq_rel);
+            front_ = previous & kIndexMask;
+            return true;
+        }
+
+        /**
+         * @brief Slot the consumer may read and modify
+         *
+         * @return T&
+         */
+        T& read_buffer() { return slots_[front_]; }
+
+    private:
+        static constexpr uint8_t kIndexMask = 0x03;
+        static constexpr uint8_t kDirty = 0x04;
+
+        std::array<T, 3> slots_;
+        uint8_t back_ = 0;                // Owned by the producer
+        std::atomic<uint8_t> middle_{1};  // Index of the shared slot | kDirty if not read yet
+        uint8_t front_ = 2;               // Owned by the consumer
+};
+
+/**
+ * @brief Camera frame stored by CameraFrameBuffer
+ *
+ */
+struct CameraFrame {
+    sensor_msgs::msg::Image::ConstSharedPtr msg;  // Raw image message, nullptr before the first frame
+    int64_t stamp = -1;                           // Header stamp in nanoseconds
+    cv::Mat bgr;                                  // BGR image, converted on first read
+};
+
+/**
+ * @brief Latest frame of one camera, written by its subscription callback and read by one worker
+ *
+ * The callback only stores the message pointer and its stamp. The bgr8 conversion runs when
+ * the consumer first reads the frame, so frames that are never read are never converted.
+ */
+class CameraFrameBuffer {
+    public:
+        /**
+         * @brief Store a new frame, called from the camera callback
+         *
+         * @param msg Image message
+         */
+        void push(const sensor_msgs::msg::Image::ConstSharedPtr& msg) {
+            CameraFrame& frame = buffer_.write_buffer();
+            frame.msg = msg;
+            frame.stamp = rclcpp::Time(msg->header.stamp).nanoseconds();
+            frame.bgr.release();
+            buffer_.publish();
+        }
+
+        /**
+         * @brief Snapshot of the latest frame, only one thread may call it
+         *
+         * @return CameraFrame Frame sharing the image data, empty bgr before the first frame
+         */
+        CameraFrame latest() {
+            buffer_.update();
+            CameraFrame& frame = buffer_.read_buffer();
+            if (frame.msg && frame.bgr.empty()) {
+                frame.bgr = cv_bridge::toCvShare(frame.msg, "bgr8")->image;
+            }
+            return frame;
+        }
+
+        /**
+         * @brief Stamp of the latest frame without converting it, only one thread may call it
+         *
+         * @return int64_t Stamp in nanoseconds, -1 before the first frame
+         */
+        int64_t stamp() {
+            buffer_.update();
+            return buffer_.read_buffer().stamp;
+        }
+
+    private:
+        TripleBuffer<CameraFrame> buffer_;
+};
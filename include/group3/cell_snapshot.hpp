@@ -0,0 +1,92 @@
+/**
+ * @copyright Copyright (c) 2023
+ * @file cell_snapshot.hpp
+ * @author Sanchit Kedia (sanchit@terpmail.umd.edu)
+ * @author Adarsh Malapaka (amalapak@terpmail.umd.edu)
+ * @author Tanmay Haldankar (tanmayh@terpmail.umd.edu)
+ * @author Sahruday Patti (sahruday@umd.edu)
+ * @author Kshitij Karnawat (kshitij@umd.edu)
+ * @brief Immutable versioned snapshot of the workcell inventory for ARIAC 2023 (Group 3)
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ *
+ */
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "bin_slot_table.hpp"
+#include "kit_tray_model.hpp"
+
+/**
+ * @brief Parts held by the robot grippers
+ *
+ */
+struct GripperParts {
+    int floor_part = -1;    // type*10 + color, -1 if nothing is attached
+    int ceiling_part = -1;  // type*10 + color, -1 if nothing is attached
+
+    bool operator==(const GripperParts& other) const {
+        return floor_part == other.floor_part && ceiling_part == other.ceiling_part;
+    }
+};
+
+/**
+ * @brief One slot that differs between two snapshots
+ *
+ */
+struct CellChange {
+    enum class Area { kBin, kConveyor, kKitTray, kGripper };
+
+    Area area;
+    int slot;    // Bin quadrant (1-72), conveyor queue index, agv*10 + tray quadrant, 0 floor / 1 ceiling gripper
+    int before;  // type*10 + color, -1 if empty
+    int after;   // type*10 + color, -1 if empty. Equal to before when only the pose or quality changed
+};
+
+/**
+ * @brief Immutable snapshot of the bins, conveyor queue, kit trays and grippers
+ *
+ * Each area is held by a shared pointer to const data. with_*() returns a new snapshot with a
+ * higher version that shares every area except the replaced one, so a snapshot is cheap to
+ * keep while the inventory it came from keeps changing. diff() skips shared areas.
+ */
+class CellSnapshot {
+    public:
+        /**
+         * @brief Empty snapshot at version 0
+         *
+         */
+        CellSnapshot();
+
+        uint64_t version() const { return version_; }
+        const BinSlotTable& bins() const { return *bins_; }
+        const std::vector<int>& conveyor() const { return *conveyor_; }
+        const KitTrayModel& kit_trays() const { return *kit_trays_; }
+        const GripperParts& grippers() const { return *grippers_; }
+
+        CellSnapshot with_bins(const BinSlotTable& bins) const;
+        CellSnapshot with_conveyor(const std::vector<int>& conveyor) const;
+        CellSnapshot with_kit_trays(const KitTrayModel& kit_trays) const;
+        CellSnapshot with_grippers(const GripperParts& grippers) const;
+
+    private:
+        friend std::vector<CellChange> diff(const CellSnapshot& a, const CellSnapshot& b);
+
+        uint64_t version_ = 0;
+        std::shared_ptr<const BinSlotTable> bins_;
+        std::shared_ptr<const std::vector<int>> conveyor_;
+        std::shared_ptr<const KitTrayModel> kit_trays_;
+        std::shared_ptr<const GripperParts> grippers_;
+};
+
+/**
+ * @brief Slots that changed from snapshot a to snapshot b, by area and then slot
+ *
+ * @param a Older snapshot
+ * @param b Newer snapshot
+ * @return std::vector<CellChange>
+ */
+std::vector<CellChange> diff(const CellSnapshot& a, const CellSnapshot& b);
@@ -0,0 +1,48 @@
+/**
+ * @copyright Copyright (c) 2023
+ * @file color_segmentation.hpp
+ * @author Sanchit Kedia (sanchit@terpmail.umd.edu)
+ * @author Adarsh Malapaka (amalapak@terpmail.umd.edu)
+ * @author Tanmay Haldankar (tanmayh@terpmail.umd.edu)
+ * @author Sahruday Patti (sahruday@umd.edu)
+ * @author Kshitij Karnawat (kshitij@umd.edu)
+ * @brief Single pass BGR to part color label segmentation for ARIAC 2023 (Group 3)
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ *
+ */
+#pragma once
+#include <opencv2/core.hpp>
+#include <ariac_msgs/msg/part.hpp>
+
+// Layout of one pixel of the packed label image produced by segment_colors()
+constexpr uchar kLabelForeground = 0x80;  // Pixel passes one of the bin part/gray inRange tests
+constexpr uchar kLabelGray = 0x40;        // Pixel matches the detect_type() gray range (H = 0, S = 0, 32 <= V <= 117)
+constexpr uchar kLabelColorMask = 0x07;   // Hue class used by detect_color() (ariac_msgs::msg::Part color)
+constexpr uchar kLabelNoColor = 0x07;     // Hue outside every detect_color() range
+
+/**
+ * @brief Function to return the part color stored in a packed label pixel
+ *
+ * @param label Packed label pixel
+ * @return int ariac_msgs::msg::Part color, -1 if the hue matches no part color
+ */
+inline int label_color(uchar label) {
+    uchar clr = label & kLabelColorMask;
+    return clr == kLabelNoColor ? -1 : clr;
+}
+
+/**
+ * @brief Function to segment a BGR image into the bin foreground mask and a per-pixel color label image
+ *
+ * Replaces the cvtColor(HSV) + seven inRange() + mask sum sequence with one traversal of the
+ * image. Pixels are classified through a precomputed 32x32x32 BGR lookup table; table cells
+ * that straddle a threshold fall back to the exact 8-bit HSV conversion used by OpenCV, so
+ * the output matches the original inRange() masks bit for bit.
+ *
+ * @param bgr Input image (CV_8UC3, BGR)
+ * @param mask Output foreground mask (CV_8UC1, 0 or 255), reallocated only if the size changes
+ * @param labels Output packed label image (CV_8UC1), reallocated only if the size changes
+ */
+void segment_colors(const cv::Mat& bgr, cv::Mat& mask, cv::Mat& labels);
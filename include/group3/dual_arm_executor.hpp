@@ -0,0 +1,195 @@
+/**
+ * @copyright Copyright (c) 2023
+ * @file dual_arm_executor.hpp
+ * @author Sanchit Kedia (sanchit@terpmail.umd.edu)
+ * @author Adarsh Malapaka (amalapak@terpmail.umd.edu)
+ * @author Tanmay Haldankar (tanmayh@terpmail.umd.edu)
+ * @author Sahruday Patti (sahruday@umd.edu)
+ * @author Kshitij Karnawat (kshitij@umd.edu)
+ * @brief Concurrent floor and ceiling robot execution for ARIAC 2023 (Group 3)
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ *
+ */
+#pragma once
+#include <array>
+#include <bitset>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+
+/**
+ * @brief Class to reserve areas of the workcell for one robot or AGV at a time
+ *
+ * A robot reserves every area an action works in before the action starts and releases
+ * them when it ends, an AGV reserves its kit tray while it drives. Areas are taken all at
+ * once and each holder holds at most one set, so two holders can never wait on each other.
+ * Motion between areas is left to the planner, which sees the other robot at its current pose.
+ */
+class WorkspaceReservations {
+    public:
+        enum Area {
+            kRightBins,     // Bins 1-4, quadrants 1-36
+            kLeftBins,      // Bins 5-8, quadrants 37-72
+            kConveyor,
+            kTrayTables,    // Kit tray tables and gripper changers of both kitting stations
+            kAgv1,          // Kit tray of an AGV at the kitting stations
+            kAgv2,
+            kAgv3,
+            kAgv4,
+            kStation1,      // Assembly station and the AGVs parked at it
+            kStation2,
+            kStation3,
+            kStation4,
+            kAreas
+        };
+
+        using AreaMask = std::bitset<kAreas>;
+
+        /**
+         * @brief Bins area of a bin quadrant
+         *
+         * @param quadrant Quadrant (1-72)
+         */
+        static AreaMask bins(int quadrant);
+
+        /**
+         * @brief Kit tray area of an AGV
+         *
+         * @param agv AGV (1-4)
+         */
+        static AreaMask agv(int agv);
+
+        /**
+         * @brief Area of an assembly station
+         *
+         * @param station Assembly station (1-4)
+         */
+        static AreaMask station(int station);
+
+        static AreaMask area(Area area);
+
+        static constexpr int kHolders = 6;  // Floor robot, ceiling robot, AGVs 1-4
+
+        /**
+         * @brief Holder index of an AGV, the robots are 0 (floor) and 1 (ceiling)
+         *
+         * @param agv AGV (1-4)
+         */
+        static int agv_holder(int agv) { return 1 + agv; }
+
+        /**
+         * @brief Block until no other holder holds any of the areas, then take them
+         *
+         * @param holder Holder index
+         * @param areas Areas to take
+         */
+        void acquire(int holder, const AreaMask& areas);
+
+        /**
+         * @brief Release every area held by a holder
+         *
+         * @param holder Holder index
+         */
+        void release(int holder);
+
+        /**
+         * @brief Areas held by a holder
+         *
+         */
+        AreaMask held(int holder) const;
+
+    private:
+        mutable std::mutex mutex_;
+        std::condition_variable released_;
+        std::array<AreaMask, kHolders> held_;
+};
+
+/**
+ * @brief Class to run floor robot and ceiling robot actions concurrently
+ *
+ * Each robot has a worker thread that runs its actions in submission order. An action
+ * reserves the workcell areas it works in for its whole duration, so the robots share the
+ * cell without parking the idle one at home. An action must not wait on an action of its own
+ * robot, it would wait on itself.
+ */
+class DualArmExecutor {
+    public:
+        enum class Arm { kFloor, kCeiling };
+
+        using Action = std::function<bool()>;
+
+        /**
+         * @brief Start a worker thread for each robot
+         *
+         */
+        DualArmExecutor();
+
+        /**
+         * @brief Stop the workers after their running actions, queued actions are dropped
+         *
+         */
+        ~DualArmExecutor();
+
+        DualArmExecutor(const DualArmExecutor&) = delete;
+        DualArmExecutor& operator=(const DualArmExecutor&) = delete;
+
+        /**
+         * @brief Queue an action on a robot
+         *
+         * @param arm Robot to run the action
+         * @param areas Areas the action works in
+         * @param action Action, returns false on failure
+         * @return std::future<bool> Result of the action
+         */
+        std::future<bool> submit(Arm arm, const WorkspaceReservations::AreaMask& areas, Action action);
+
+        /**
+         * @brief Queue an action on a robot and wait for it
+         *
+         * @param arm Robot to run the action
+         * @param areas Areas the action works in
+         * @param action Action, returns false on failure
+         * @return bool Result of the action
+         */
+        bool run(Arm arm, const WorkspaceReservations::AreaMask& areas, Action action) {
+            return submit(arm, areas, std::move(action)).get();
+        }
+
+        /**
+         * @brief Whether a robot has no running or queued action
+         *
+         */
+        bool idle(Arm arm) const;
+
+        /**
+         * @brief Areas held by the robots, shared with the AGV moves
+         *
+         */
+        WorkspaceReservations& reservations() { return reservations_; }
+
+    private:
+        struct Job {
+            WorkspaceReservations::AreaMask areas;
+            Action action;
+            std::promise<bool> done;
+        };
+
+        struct Worker {
+            std::deque<Job> jobs;
+            bool busy = false;
+            std::thread thread;
+        };
+
+        void work(int robot);
+
+        WorkspaceReservations reservations_;
+        mutable std::mutex mutex_;
+        std::condition_variable queued_;
+        bool stop_ = false;
+        std::array<Worker, 2> workers_;
+};
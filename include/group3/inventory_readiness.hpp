@@ -0,0 +1,59 @@
+/**
+ * @copyright Copyright (c) 2023
+ * @file inventory_readiness.hpp
+ * @author Sanchit Kedia (sanchit@terpmail.umd.edu)
+ * @author Adarsh Malapaka (amalapak@terpmail.umd.edu)
+ * @author Tanmay Haldankar (tanmayh@terpmail.umd.edu)
+ * @author Sahruday Patti (sahruday@umd.edu)
+ * @author Kshitij Karnawat (kshitij@umd.edu)
+ * @brief Bin inventory readiness signalling for ARIAC 2023 (Group 3)
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ *
+ */
+#pragma once
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+/**
+ * @brief Class to wait for bin part detections without spinning
+ *
+ * The part detector callbacks call notify() with the stamp of the image each detection was
+ * made from. Waiting threads sleep on a condition variable until every bin camera has reported
+ * a detection newer than the given stamps.
+ */
+class InventoryReadiness {
+    public:
+        static constexpr int kRightBins = 0;
+        static constexpr int kLeftBins = 1;
+        static constexpr int kSources = 2;
+
+        using Stamps = std::array<int64_t, kSources>;  // Image stamp (ns) per bin camera
+
+        /**
+         * @brief Record a detection, called from the part detector callbacks
+         *
+         * @param source kRightBins or kLeftBins
+         * @param stamp Stamp of the image the detection was made from, in nanoseconds
+         */
+        void notify(int source, int64_t stamp);
+
+        /**
+         * @brief Block until every bin camera has a detection newer than the given stamps
+         *
+         * @param after Stamp per bin camera, -1 to accept any detection
+         * @param timeout Maximum time to wait
+         * @return true The detections are available
+         * @return false Timed out
+         */
+        bool wait_newer(const Stamps& after, std::chrono::milliseconds timeout) const;
+
+    private:
+        mutable std::mutex mutex_;
+        mutable std::condition_variable cv_;
+        Stamps stamps_{-1, -1};
+};
@@ -0,0 +1,147 @@
+/**
+ * @copyright Copyright (c) 2023
+ * @file kit_tray_model.hpp
+ * @author Sanchit Kedia (sanchit@terpmail.umd.edu)
+ * @author Adarsh Malapaka (amalapak@terpmail.umd.edu)
+ * @author Tanmay Haldankar (tanmayh@terpmail.umd.edu)
+ * @author Sahruday Patti (sahruday@umd.edu)
+ * @author Kshitij Karnawat (kshitij@umd.edu)
+ * @brief Per AGV kit tray occupancy model for ARIAC 2023 (Group 3)
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ *
+ */
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <geometry_msgs/msg/pose.hpp>
+
+#include "bin_slot_table.hpp"
+
+/**
+ * @brief Class to track the parts on the kit tray of every AGV
+ *
+ * Each AGV tray quadrant holds at most one part, recorded with its placed pose, the order it
+ * was placed for and its last quality check result. Parts of one type and color are indexed
+ * by a bit mask of tray cells, so finding a part to reuse is a mask lookup.
+ */
+class KitTrayModel {
+    public:
+        static constexpr int kAgvs = 4;
+        static constexpr int kQuadrants = 4;
+
+        enum class Quality { kUnchecked, kPassed, kFlipped, kFaulty };
+
+        /**
+         * @brief Part on a kit tray quadrant
+         *
+         */
+        struct TrayPart {
+            int part_type_clr = -1;          // type*10 + color, -1 if the quadrant is empty
+            geometry_msgs::msg::Pose pose;   // Pose the part was placed at
+            std::string order_id;            // Order the part was placed for
+            Quality quality = Quality::kUnchecked;
+        };
+
+        /**
+         * @brief Kit tray quadrant of an AGV
+         *
+         */
+        struct Location {
+            int agv = -1;       // AGV (1-4), -1 if not found
+            int quadrant = -1;  // Tray quadrant (1-4)
+
+            bool valid() const { return agv != -1; }
+        };
+
+        KitTrayModel();
+
+        /**
+         * @brief Record a part placed on a tray quadrant, replacing what the quadrant held
+         *
+         * @param agv AGV (1-4)
+         * @param quadrant Tray quadrant (1-4)
+         * @param part_type_clr type*10 + color
+         * @param pose Placed pose
+         * @param order_id Order the part was placed for
+         * @return false The AGV or quadrant is out of range
+         */
+        bool place(int agv, int quadrant, int part_type_clr, const geometry_msgs::msg::Pose& pose,
+                   const std::string& order_id);
+
+        /**
+         * @brief Empty a tray quadrant, called when its part is picked
+         *
+         * @param agv AGV (1-4)
+         * @param quadrant Tray quadrant (1-4)
+         */
+        void remove(int agv, int quadrant);
+
+        /**
+         * @brief Empty the tray of an AGV, called when the AGV leaves the kitting area
+         *
+         * @param agv AGV (1-4)
+         */
+        void clear(int agv);
+
+        /**
+         * @brief Set the quality check result of a tray quadrant
+         *
+         * A faulty part is no longer offered by find().
+         *
+         * @param agv AGV (1-4)
+         * @param quadrant Tray quadrant (1-4)
+         * @param quality Check result
+         */
+        void set_quality(int agv, int quadrant, Quality quality);
+
+        /**
+         * @brief Part on a tray quadrant
+         *
+         * @param agv AGV (1-4)
+         * @param quadrant Tray quadrant (1-4)
+         * @return const TrayPart& Empty part when out of range
+         */
+        const TrayPart& at(int agv, int quadrant) const;
+
+        /**
+         * @brief Find a part of a type and color placed for another order
+         *
+         * @param part_type_clr type*10 + color
+         * @param order_id Order looking for the part, its own parts are skipped
+         * @return Location Lowest AGV and quadrant holding the part, invalid if none
+         */
+        Location find(int part_type_clr, const std::string& order_id) const;
+
+        /**
+         * @brief Parts that find() may hand out, one entry per part
+         *
+         * @return std::vector<int> type*10 + color
+         */
+        std::vector<int> reusable_parts() const;
+
+        /**
+         * @brief Number of parts on all trays
+         *
+         */
+        int size() const;
+
+        /**
+         * @brief Counter bumped by every change to a tray quadrant
+         *
+         * @return uint64_t
+         */
+        uint64_t revision() const { return revision_; }
+
+    private:
+        static int cell(int agv, int quadrant);
+
+        std::array<TrayPart, kAgvs * kQuadrants> cells_;
+        std::array<uint16_t, BinSlotTable::kTypes * BinSlotTable::kColors> reusable_;  // Cells per part, faulty parts excluded
+        TrayPart empty_;
+        uint64_t revision_ = 0;
+};
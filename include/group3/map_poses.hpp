@@ -12,11 +12,107 @@
  * 
  * 
  */
-#include <iostream>
-#include <vector>
-#include <map>
-#include <rclcpp/rclcpp.hpp>
+#pragma once
 #include <geometry_msgs/msg/pose.hpp>
 
-std::map<int, geometry_msgs::msg::Pose> define_poses();
-std::map<int, geometry_msgs::msg::Pose> define_tray_poses();
\ No newline at end of file
+/**
+ * @brief Position of a bin quadrant or kit tray in the world frame, parts lie flat (identity orientation)
+ *
+ */
+struct MapPosition {
+    double x;
+    double y;
+    double z;
+};
+
+constexpr int kBinCount = 8;
+constexpr int kQuadrantsPerBin = 9;
+constexpr int kBinQuadrantCount = kBinCount * kQuadrantsPerBin;
+constexpr int kTrayCount = 6;
+
+constexpr double kBinQuadrantPitch = 0.18;  // Distance between neighbouring quadrant centers
+constexpr double kBinPartZ = 0.723481;
+constexpr double kTrayPitch = 0.43;         // Distance between neighbouring tray slots of a kit tray station
+constexpr double kTrayZ = 0.73499;
+
+// Center of the first quadrant of every bin, the other quadrants follow at kBinQuadrantPitch
+// along +x every 3 quadrants and along +y within each group of 3
+constexpr MapPosition kBinOrigins[kBinCount] = {
+    {-2.08, 3.195, kBinPartZ},    // Bin 1, quadrants 1-9
+    {-2.08, 2.445, kBinPartZ},    // Bin 2, quadrants 10-18
+    {-2.83, 2.445, kBinPartZ},    // Bin 3, quadrants 19-27
+    {-2.83, 3.195, kBinPartZ},    // Bin 4, quadrants 28-36
+    {-2.08, -3.555, kBinPartZ},   // Bin 5, quadrants 37-45
+    {-2.08, -2.805, kBinPartZ},   // Bin 6, quadrants 46-54
+    {-2.83, -2.805, kBinPartZ},   // Bin 7, quadrants 55-63
+    {-2.83, -3.555, kBinPartZ}};  // Bin 8, quadrants 64-72
+
+/**
+ * @brief Position of a bin quadrant
+ *
+ * @param quadrant Quadrant (1-72)
+ * @return constexpr MapPosition
+ */
+constexpr MapPosition bin_quadrant_position(int quadrant) {
+    return {kBinOrigins[(quadrant - 1) / kQuadrantsPerBin].x + kBinQuadrantPitch * (((quadrant - 1) % kQuadrantsPerBin) / 3),
+            kBinOrigins[(quadrant - 1) / kQuadrantsPerBin].y + kBinQuadrantPitch * ((quadrant - 1) % 3),
+            kBinPartZ};
+}
+
+/**
+ * @brief Position of a tray slot, 0-2 on kts1 and 3-5 on kts2
+ *
+ * @param tray Tray slot (0-5)
+ * @return constexpr MapPosition
+ */
+constexpr MapPosition tray_position(int tray) {
+    return tray < 3 ? MapPosition{-0.87 - kTrayPitch * tray, -5.84, kTrayZ}
+                    : MapPosition{-1.73 + kTrayPitch * (tray - 3), 5.84, kTrayZ};
+}
+
+/**
+ * @brief Table of map positions computed at compile time
+ *
+ * @tparam N Number of positions
+ */
+template <int N>
+struct MapPositionTable {
+    MapPosition positions[N];
+
+    constexpr const MapPosition& operator[](int i) const { return positions[i]; }
+};
+
+constexpr MapPositionTable<kBinQuadrantCount> make_bin_quadrant_positions() {
+    MapPositionTable<kBinQuadrantCount> table{};
+    for (int quadrant = 1; quadrant <= kBinQuadrantCount; quadrant++) {
+        table.positions[quadrant - 1] = bin_quadrant_position(quadrant);
+    }
+    return table;
+}
+
+constexpr MapPositionTable<kTrayCount> make_tray_positions() {
+    MapPositionTable<kTrayCount> table{};
+    for (int tray = 0; tray < kTrayCount; tray++) {
+        table.positions[tray] = tray_position(tray);
+    }
+    return table;
+}
+
+constexpr MapPositionTable<kBinQuadrantCount> kBinQuadrantPositions = make_bin_quadrant_positions();  // Index quadrant - 1
+constexpr MapPositionTable<kTrayCount> kTrayPositions = make_tray_positions();
+
+/**
+ * @brief Pose of a bin quadrant, built once from kBinQuadrantPositions
+ *
+ * @param quadrant Quadrant (1-72)
+ * @return const geometry_msgs::msg::Pose& Pose, identity pose at the origin for an unknown quadrant
+ */
+const geometry_msgs::msg::Pose& bin_quadrant_pose(int quadrant);
+
+/**
+ * @brief Pose of a tray slot, built once from kTrayPositions
+ *
+ * @param tray Tray slot (0-5), 0-2 on kts1 and 3-5 on kts2
+ * @return const geometry_msgs::msg::Pose& Pose, identity pose at the origin for an unknown slot
+ */
+const geometry_msgs::msg::Pose& tray_pose(int tray);
@@ -0,0 +1,131 @@
+/**
+ * @copyright Copyright (c) 2023
+ * @file order_queue.hpp
+ * @author Sanchit Kedia (sanchit@terpmail.umd.edu)
+ * @author Adarsh Malapaka (amalapak@terpmail.umd.edu)
+ * @author Tanmay Haldankar (tanmayh@terpmail.umd.edu)
+ * @author Sahruday Patti (sahruday@umd.edu)
+ * @author Kshitij Karnawat (kshitij@umd.edu)
+ * @brief Priority queue of accepted orders for ARIAC 2023 (Group 3)
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ *
+ */
+#pragma once
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * @brief Thread safe queue of orders waiting to be processed
+ *
+ * Orders are kept in a balanced tree keyed on (priority first, announcement time, arrival
+ * sequence), so insertion and popping the next order are O(log n) and orders of the same
+ * priority and time leave in arrival order. An index from order ID to key makes removal by ID
+ * O(log n) as well. Orders are moved in and out, never copied.
+ *
+ * @tparam T Order type
+ */
+template <typename T>
+class OrderQueue {
+    public:
+        /**
+         * @brief Add an order
+         *
+         * @param order Order, moved into the queue
+         * @param id Order ID
+         * @param priority true for a priority order, dispatched before every regular order
+         * @param announced_ns Announcement time in nanoseconds
+         * @return false An order with this ID is already queued, the order is dropped
+         */
+        bool push(T order, const std::string& id, bool priority, int64_t announced_ns) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (index_.count(id) != 0) {
+                return false;
+            }
+            Key key{priority ? 0 : 1, announced_ns, next_sequence_++};
+            queue_.emplace(key, Entry{id, std::move(order)});
+            index_.emplace(id, key);
+            return true;
+        }
+
+        /**
+         * @brief Remove and return the next order, the queue must not be empty
+         *
+         * @return T
+         */
+        T pop() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = queue_.begin();
+            T order = std::move(it->second.order);
+            index_.erase(it->second.id);
+            queue_.erase(it);
+            return order;
+        }
+
+        /**
+         * @brief Remove an order by ID
+         *
+         * @param id Order ID
+         * @return false No order with this ID is queued
+         */
+        bool remove(const std::string& id) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = index_.find(id);
+            if (it == index_.end()) {
+                return false;
+            }
+            queue_.erase(it->second);
+            index_.erase(it);
+            return true;
+        }
+
+        /**
+         * @brief Whether the next order is a priority order
+         *
+         */
+        bool front_is_priority() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return !queue_.empty() && std::get<0>(queue_.begin()->first) == 0;
+        }
+
+        bool empty() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return queue_.empty();
+        }
+
+        size_t size() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return queue_.size();
+        }
+
+        /**
+         * @brief Call fn for every queued order in dispatch order, with the queue locked
+         *
+         */
+        template <typename Fn>
+        void for_each(Fn fn) const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (const auto& entry : queue_) {
+                fn(entry.second.order);
+            }
+        }
+
+    private:
+        using Key = std::tuple<int, int64_t, uint64_t>;  // Priority rank, announcement time, arrival sequence
+
+        struct Entry {
+            std::string id;
+            T order;
+        };
+
+        mutable std::mutex mutex_;
+        std::map<Key, Entry> queue_;
+        std::unordered_map<std::string, Key> index_;
+        uint64_t next_sequence_ = 0;
+};
@@ -0,0 +1,133 @@
+/**
+ * @copyright Copyright (c) 2023
+ * @file order_task.hpp
+ * @author Sanchit Kedia (sanchit@terpmail.umd.edu)
+ * @author Adarsh Malapaka (amalapak@terpmail.umd.edu)
+ * @author Tanmay Haldankar (tanmayh@terpmail.umd.edu)
+ * @author Sahruday Patti (sahruday@umd.edu)
+ * @author Kshitij Karnawat (kshitij@umd.edu)
+ * @brief Resumable progress of a started order for ARIAC 2023 (Group 3)
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ *
+ */
+#pragma once
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <ariac_msgs/msg/part_pose.hpp>
+
+/**
+ * @brief Started order and the last checkpoint it reached
+ *
+ * An order runs through the stages in declaration order. Kitting orders skip kAssemble,
+ * assembly orders skip kTray, kParts and kQualityCheck. Within kParts, kMoveAgv and kAssemble
+ * the task counts the items done so far (kit parts, AGVs moved, parts assembled). The task is
+ * checkpointed after every tray place, part place and AGV move, so a task suspended for a
+ * priority order resumes at the first item it has not done.
+ *
+ * @tparam T Order type
+ */
+template <typename T>
+class OrderTask {
+    public:
+        enum class Stage { kConveyor, kTray, kParts, kQualityCheck, kMoveAgv, kAssemble, kDone };
+
+        /**
+         * @brief Start an order at kConveyor
+         *
+         * @param order Order, moved into the task
+         */
+        explicit OrderTask(T order) : order_(std::move(order)) {}
+
+        const T& order() const { return order_; }
+        Stage stage() const { return stage_; }
+
+        /**
+         * @brief Items of the current stage done so far
+         *
+         */
+        size_t item() const { return item_; }
+
+        /**
+         * @brief Checkpoint the end of the current stage, the item count restarts at 0
+         *
+         * @param next Stage to run next
+         */
+        void finish_stage(Stage next) {
+            stage_ = next;
+            item_ = 0;
+        }
+
+        /**
+         * @brief Checkpoint one item of the current stage
+         *
+         */
+        void finish_item() { item_++; }
+
+        /**
+         * @brief AGV carrying the kit tray of a combined order, -1 until one is chosen
+         *
+         */
+        int agv() const { return agv_; }
+        void set_agv(int agv) { agv_ = agv; }
+
+        /**
+         * @brief Kit tray quadrants filled so far by a combined order, parts that were not found take none
+         *
+         */
+        int tray_slot() const { return tray_slot_; }
+        void use_tray_slot() { tray_slot_++; }
+
+        /**
+         * @brief Poses of the parts on the AGVs, fetched when kAssemble starts
+         *
+         */
+        const std::vector<ariac_msgs::msg::PartPose>& assembly_poses() const { return assembly_poses_; }
+        void set_assembly_poses(std::vector<ariac_msgs::msg::PartPose> poses) { assembly_poses_ = std::move(poses); }
+
+        /**
+         * @brief Mark the task as left at its checkpoint for a priority order
+         *
+         */
+        void suspend() { suspended_ = true; }
+
+        /**
+         * @brief Clear the suspended mark
+         *
+         * @return true The task was suspended, the workcell may have changed since its last checkpoint
+         */
+        bool resume() {
+            bool suspended = suspended_;
+            suspended_ = false;
+            return suspended;
+        }
+
+        /**
+         * @brief Name of a stage for logging
+         *
+         */
+        static const char* stage_name(Stage stage) {
+            switch (stage) {
+                case Stage::kConveyor: return "conveyor";
+                case Stage::kTray: return "tray";
+                case Stage::kParts: return "parts";
+                case Stage::kQualityCheck: return "quality check";
+                case Stage::kMoveAgv: return "move agv";
+                case Stage::kAssemble: return "assemble";
+                case Stage::kDone: return "done";
+            }
+            return "unknown";
+        }
+
+    private:
+        T order_;
+        Stage stage_ = Stage::kConveyor;
+        size_t item_ = 0;
+        int agv_ = -1;
+        int tray_slot_ = 0;
+        bool suspended_ = false;
+        std::vector<ariac_msgs::msg::PartPose> assembly_poses_;
+};
@@ -0,0 +1,96 @@
+/**
+ * @copyright Copyright (c) 2023
+ * @file part_detector.hpp
+ * @author Sanchit Kedia (sanchit@terpmail.umd.edu)
+ * @author Adarsh Malapaka (amalapak@terpmail.umd.edu)
+ * @author Tanmay Haldankar (tanmayh@terpmail.umd.edu)
+ * @author Sahruday Patti (sahruday@umd.edu)
+ * @author Kshitij Karnawat (kshitij@umd.edu)
+ * @brief Composable part detector node for ARIAC 2023 (Group 3)
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ *
+ */
+#pragma once
+#include <rclcpp/rclcpp.hpp>
+#include <sensor_msgs/msg/image.hpp>
+#include "cv_bridge/cv_bridge.h"
+
+#include "group3/msg/bin_slots.hpp"
+#include "group3/msg/part.hpp"
+
+#include "part_type_detect.hpp"
+#include "bin_grid_detector.hpp"
+
+/**
+ * @brief Class definition for the bin and conveyor part detector
+ *
+ * Publishes the parts seen by the right bins, left bins and conveyor RGB cameras. Messages
+ * are published as unique_ptr, so when the node shares a process with AriacCompetition and
+ * intra-process communication is enabled they reach the subscribers without a copy.
+ */
+class PartDetector : public rclcpp::Node {
+    public:
+        /**
+         * @brief Construct a new Part Detector object
+         *
+         * @param options Node options, use_intra_process_comms(true) to pass messages without copying
+         */
+        explicit PartDetector(const rclcpp::NodeOptions& options);
+
+    private:
+        /**
+         * @brief Callback function for right bins RGB camera subscriber
+         *
+         * @param msg Image message
+         */
+        void right_bins_rgb_camera_cb(const sensor_msgs::msg::Image::ConstSharedPtr msg);
+
+        /**
+         * @brief Callback function for left bins RGB camera subscriber
+         *
+         * @param msg Image message
+         */
+        void left_bins_rgb_camera_cb(const sensor_msgs::msg::Image::ConstSharedPtr msg);
+
+        /**
+         * @brief Callback function for conveyor RGB camera subscriber
+         *
+         * @param msg Image message
+         */
+        void conv_rgb_camera_cb(const sensor_msgs::msg::Image::ConstSharedPtr msg);
+
+        /**
+         * @brief Method to detect the parts in a bins camera image and publish them
+         *
+         * @param detector Detector of the camera
+         * @param slots Slot table of the camera, reused across frames
+         * @param msg Image message
+         * @param sequence Detection count of the camera, incremented
+         * @param publisher Publisher of the camera
+         */
+        void publish_bin_parts(BinGridDetector& detector,
+                               BinSlotDetections& slots,
+                               const sensor_msgs::msg::Image::ConstSharedPtr& msg,
+                               uint32_t& sequence,
+                               const rclcpp::Publisher<group3::msg::BinSlots>::SharedPtr& publisher);
+
+        BinGridDetector right_bins_detector_{right_bins_layout()};
+        BinGridDetector left_bins_detector_{left_bins_layout()};
+        BinSlotDetections right_bins_slots_;
+        BinSlotDetections left_bins_slots_;
+        uint32_t right_bins_sequence_ = 0;
+        uint32_t left_bins_sequence_ = 0;
+
+        rclcpp::CallbackGroup::SharedPtr right_bins_cb_group_;
+        rclcpp::CallbackGroup::SharedPtr left_bins_cb_group_;
+
+        rclcpp::Subscription<sensor_msgs::msg::Image>::SharedPtr right_bins_rgb_camera_sub_;
+        rclcpp::Subscription<sensor_msgs::msg::Image>::SharedPtr left_bins_rgb_camera_sub_;
+        rclcpp::Subscription<sensor_msgs::msg::Image>::SharedPtr conv_rgb_camera_sub_;
+
+        rclcpp::Publisher<group3::msg::BinSlots>::SharedPtr right_part_detector_pub_;
+        rclcpp::Publisher<group3::msg::BinSlots>::SharedPtr left_part_detector_pub_;
+        rclcpp::Publisher<group3::msg::Part>::SharedPtr conv_part_detector_pub_;
+};
@@ -22,30 +22,48 @@
 #include <vector>
 #include <iostream>
 
+#include "color_segmentation.hpp"
+
 /**
- * @brief Function to return the type of the parts in the image
+ * @brief Color and type of a detected part
  * 
- * @param img 
- * @param cnt 
+ */
+struct PartInfo {
+    int color = -1;  // ariac_msgs::msg::Part color, -1 if the hue matches no part color
+    int type = 0;    // ariac_msgs::msg::Part type, 0 if unknown
+};
+
+/**
+ * @brief Function to return the type of a part from the gray areas inside its bounding box
+ * 
+ * Works on views of the label image and reuses per-thread scratch buffers, so no image is
+ * allocated per part once the buffers have grown to the largest part seen.
+ * 
+ * @param labels Packed label image of the bin (segment_colors())
+ * @param mask Foreground mask of the bin after morphology
+ * @param cnt Contour of the part
  * @return int 
  */
-int detect_type(cv::Mat img, std::vector<cv::Point> cnt);
+int detect_type(const cv::Mat& labels, const cv::Mat& mask, const std::vector<cv::Point>& cnt);
 
 /**
- * @brief Function to return the color of the parts in the image
+ * @brief Function to return the color and type of a part
  * 
- * @param img 
- * @param new_image 
- * @param c 
- * @param x_m 
- * @param y_m 
- * @return std::vector<int> 
+ * @param labels Packed label image of the bin (segment_colors())
+ * @param mask Foreground mask of the bin after morphology
+ * @param c Contour of the part
+ * @param x_m Centroid x
+ * @param y_m Centroid y
+ * @return PartInfo 
  */
-std::vector<int> detect_color(cv::Mat img, cv::Mat new_image, std::vector<cv::Point> c, int x_m, int y_m);
+PartInfo detect_color(const cv::Mat& labels, const cv::Mat& mask, const std::vector<cv::Point>& c, int x_m, int y_m);
 
 /**
  * @brief Function to return the right bin parts
  * 
+ * Each thread uses its own BinGridDetector (sequential, not incremental), so concurrent
+ * callers do not share the detector's per-bin buffers.
+ * 
  * @param img 
  * @return std::vector<std::vector<int>> 
  */
@@ -54,7 +72,27 @@ std::vector<std::vector<int>> rightbin(cv::Mat img);
 /**
  * @brief Function to return the left bin parts
  * 
+ * Each thread uses its own BinGridDetector (sequential, not incremental), so concurrent
+ * callers do not share the detector's per-bin buffers.
+ * 
  * @param img 
  * @return std::vector<std::vector<int>> 
  */
-std::vector<std::vector<int>> leftbin(cv::Mat img);
\ No newline at end of file
+std::vector<std::vector<int>> leftbin(cv::Mat img);
+
+/**
+ * @brief Function to return the type of a part on the conveyor
+ * 
+ * @param img 
+ * @param cnt 
+ * @return int 
+ */
+int conveyor_detect_type(cv::Mat img, std::vector<cv::Point> cnt);
+
+/**
+ * @brief Function to return the conveyor parts
+ * 
+ * @param img 
+ * @return std::vector<std::vector<int>> {color, type, 0} of every part in the conveyor camera image
+ */
+std::vector<std::vector<int>> conveyor(cv::Mat img);
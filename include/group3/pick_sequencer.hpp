@@ -0,0 +1,117 @@
+/**
+ * @copyright Copyright (c) 2023
+ * @file pick_sequencer.hpp
+ * @author Sanchit Kedia (sanchit@terpmail.umd.edu)
+ * @author Adarsh Malapaka (amalapak@terpmail.umd.edu)
+ * @author Tanmay Haldankar (tanmayh@terpmail.umd.edu)
+ * @author Sahruday Patti (sahruday@umd.edu)
+ * @author Kshitij Karnawat (kshitij@umd.edu)
+ * @brief Kit pick sequencing over rail and gantry travel for ARIAC 2023 (Group 3)
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ *
+ */
+#pragma once
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "bin_slot_table.hpp"
+
+/**
+ * @brief Travel time of the robots between the bins and the kit tray of one AGV
+ *
+ * The floor robot picks from rail_positions_[bin side] and places at rail_positions_["agvN"],
+ * the ceiling robot does the same on gantry_positions_. A pick moves the robot from where it
+ * is to the bin side and then to the AGV. Slots outside the floor robot's workspace are picked
+ * by the ceiling robot, which also leaves the assembly station for it.
+ */
+struct PickTravelModel {
+    double rail_position = 0.0;       // Current linear_actuator_joint position
+    double gantry_position = 0.0;     // Current gantry_y_axis_joint position
+    double right_bins_rail = -3.0;
+    double left_bins_rail = 3.0;
+    double agv_rail = 0.0;            // Rail position of the AGV receiving the kit
+    double right_bins_gantry = -2.8;
+    double left_bins_gantry = 2.8;
+    double agv_gantry = 0.0;          // Gantry position of the AGV receiving the kit
+    double rail_speed = 1.0;          // m/s
+    double gantry_speed = 0.5;        // m/s
+    double ceiling_overhead = 10.0;   // Seconds added to every ceiling robot pick
+    SlotMask floor_reachable;         // Slots in the floor robot's workspace
+
+    /**
+     * @brief Seconds to pick from a slot and reach the AGV, moving the robot that picks
+     *
+     * @param slot Slot (quadrant - 1)
+     * @param rail Floor robot rail position, set to the AGV if the floor robot picks
+     * @param gantry Ceiling robot gantry position, set to the AGV if the ceiling robot picks
+     * @return double
+     */
+    double pick(int slot, double& rail, double& gantry) const;
+};
+
+/**
+ * @brief One pick of a kit
+ *
+ */
+struct PickStep {
+    int part;      // Index of the part in the kit
+    int quadrant;  // Bin quadrant supplying the part, -1 if no bin holds it
+};
+
+/**
+ * @brief Sequence of picks for a kit
+ *
+ */
+struct PickPlan {
+    std::vector<PickStep> steps;  // One step per kit part, parts no bin holds come last
+    double seconds = 0.0;         // Estimated travel time of the steps left when planned
+};
+
+/**
+ * @brief Class to choose the slot supplying each kit part and the order of the picks
+ *
+ * Every slot holding a part is a candidate, but slots on the same bin side and with the same
+ * robot cost the same, so each part only branches on four classes (side x robot) and takes the
+ * lowest free slot of the class. Kits up to kMaxExact parts are searched exhaustively with
+ * branch and bound, larger ones take the cheapest next pick greedily.
+ *
+ * Plans are cached per order. A cached plan is kept while the slots it still has to pick hold
+ * their parts and no missing part has turned up, otherwise the remaining steps are planned
+ * again from the current robot positions. The steps already done are never reordered, so the
+ * item counter of a resumed order still indexes the plan.
+ */
+class PickSequencer {
+    public:
+        static constexpr size_t kMaxExact = 5;
+
+        /**
+         * @brief Plan for the picks of a kit, cached per order
+         *
+         * @param order_id Order ID
+         * @param parts type*10 + color of each kit part
+         * @param done Steps of the cached plan already done
+         * @param bins Bin slot table
+         * @param excluded Slots the order must not take
+         * @param model Travel model at the current robot positions
+         * @return const PickPlan&
+         */
+        const PickPlan& plan(const std::string& order_id, const std::vector<int>& parts, size_t done,
+                             const BinSlotTable& bins, const SlotMask& excluded, const PickTravelModel& model);
+
+        /**
+         * @brief Drop the cached plan of an order
+         *
+         * @param order_id Order ID
+         */
+        void forget(const std::string& order_id) { plans_.erase(order_id); }
+
+    private:
+        bool valid(const PickPlan& plan, const std::vector<int>& parts, size_t done,
+                   const BinSlotTable& bins, const SlotMask& excluded) const;
+
+        std::map<std::string, PickPlan> plans_;
+};
@@ -0,0 +1,138 @@
+/**
+ * @copyright Copyright (c) 2023
+ * @file reservation_ledger.hpp
+ * @author Sanchit Kedia (sanchit@terpmail.umd.edu)
+ * @author Adarsh Malapaka (amalapak@terpmail.umd.edu)
+ * @author Tanmay Haldankar (tanmayh@terpmail.umd.edu)
+ * @author Sahruday Patti (sahruday@umd.edu)
+ * @author Kshitij Karnawat (kshitij@umd.edu)
+ * @brief Part reservation ledger for ARIAC 2023 (Group 3)
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ *
+ */
+#pragma once
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "bin_slot_table.hpp"
+
+/**
+ * @brief Class to reserve the parts of accepted orders before they are picked
+ *
+ * An order reserves its whole bill of materials in one call when it is accepted, taking bin
+ * quadrants first, then parts still to arrive on the conveyor, then parts already placed on a
+ * kit tray. Parts nobody can supply are reported as shortages and reserved again by retry()
+ * when the inventory changes. A priority order may take bin quadrants reserved by a regular
+ * order, which then reports them as shortages. A conveyor reservation becomes a bin reservation
+ * when the part is placed in a bin. Reservations are dropped as parts are picked and released
+ * when the order completes or is aborted.
+ */
+class ReservationLedger {
+    public:
+        enum class Source { kBin, kConveyor, kKitTray };
+
+        /**
+         * @brief One reserved part
+         *
+         */
+        struct Reservation {
+            int part_type_clr;  // type*10 + color
+            Source source;
+            int quadrant;       // Bin quadrant (1-72) for Source::kBin, -1 otherwise
+        };
+
+        /**
+         * @brief Reserve the parts of an order, an order that already holds reservations only retries its shortages
+         *
+         * @param order_id Order ID
+         * @param priority true for a priority order
+         * @param bill Parts of the order (type*10 + color), one entry per part
+         * @param bins Current bin slot table
+         * @param conveyor_parts Parts still to arrive on the conveyor (type*10 + color)
+         * @param kit_tray_parts Parts already placed on a kit tray (type*10 + color)
+         * @return std::vector<int> Parts of the bill that could not be reserved
+         */
+        std::vector<int> reserve(const std::string& order_id, bool priority, const std::vector<int>& bill,
+                                 const BinSlotTable& bins, const std::vector<int>& conveyor_parts,
+                                 const std::vector<int>& kit_tray_parts);
+
+        /**
+         * @brief Reserve the shortages of every order again, priority orders first
+         *
+         * @param bins Current bin slot table
+         * @param conveyor_parts Parts still to arrive on the conveyor (type*10 + color)
+         * @param kit_tray_parts Parts already placed on a kit tray (type*10 + color)
+         * @return int Number of parts reserved
+         */
+        int retry(const BinSlotTable& bins, const std::vector<int>& conveyor_parts, const std::vector<int>& kit_tray_parts);
+
+        /**
+         * @brief Turn a conveyor reservation of a part into a reservation of the bin quadrant it was placed in
+         *
+         * The reservation of a priority order is moved first. Nothing changes if no order reserved the part
+         * on the conveyor.
+         *
+         * @param part_type_clr type*10 + color of the part
+         * @param quadrant Bin quadrant (1-72) the part was placed in
+         * @return true A reservation was moved
+         */
+        bool conveyor_part_placed(int part_type_clr, int quadrant);
+
+        /**
+         * @brief Drop the reservations of an order, called when it completes or is aborted
+         *
+         * @param order_id Order ID
+         */
+        void release(const std::string& order_id);
+
+        /**
+         * @brief Bin quadrants an order must not pick because other orders reserved them
+         *
+         * Quadrants reserved by regular orders do not block a priority order.
+         *
+         * @param order_id Order ID
+         * @return SlotMask Blocked slots (quadrant - 1)
+         */
+        SlotMask blocked_for(const std::string& order_id) const;
+
+        /**
+         * @brief Drop the reservation of a part the order has picked
+         *
+         * A bin part picked from another quadrant than the reserved one frees the reserved quadrant.
+         *
+         * @param order_id Order ID
+         * @param part_type_clr type*10 + color of the part
+         * @param source Where the part was picked from
+         * @param quadrant Bin quadrant (1-72) for Source::kBin
+         */
+        void consume(const std::string& order_id, int part_type_clr, Source source, int quadrant = -1);
+
+        /**
+         * @brief Parts of an order that could not be reserved
+         *
+         * @param order_id Order ID
+         * @return std::vector<int> type*10 + color of the missing parts
+         */
+        std::vector<int> shortages(const std::string& order_id) const;
+
+    private:
+        struct OrderEntry {
+            bool priority = false;
+            std::vector<Reservation> reservations;
+            std::vector<int> shortages;
+        };
+
+        int reserved_count(int part_type_clr, Source source) const;
+        bool reserve_part(const std::string& order_id, OrderEntry& order, int part_type_clr, const BinSlotTable& bins,
+                          const std::vector<int>& conveyor_parts, const std::vector<int>& kit_tray_parts);
+        bool steal_bin(const std::string& order_id, int part_type_clr, const BinSlotTable& bins, int& quadrant);
+        void unreserve(int quadrant);
+
+        mutable std::mutex mutex_;
+        std::map<std::string, OrderEntry> orders_;
+        SlotMask reserved_;  // Bin slots reserved by any order
+};
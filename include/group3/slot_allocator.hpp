@@ -0,0 +1,81 @@
+/**
+ * @copyright Copyright (c) 2023
+ * @file slot_allocator.hpp
+ * @author Sanchit Kedia (sanchit@terpmail.umd.edu)
+ * @author Adarsh Malapaka (amalapak@terpmail.umd.edu)
+ * @author Tanmay Haldankar (tanmayh@terpmail.umd.edu)
+ * @author Sahruday Patti (sahruday@umd.edu)
+ * @author Kshitij Karnawat (kshitij@umd.edu)
+ * @brief Free bin slot allocator for ARIAC 2023 (Group 3)
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ *
+ */
+#pragma once
+#include <array>
+
+#include "bin_slot_table.hpp"
+
+/**
+ * @brief Hands out free bin slots to drop conveyor parts in
+ *
+ * Free slots are kept as one mask per bin side and reachability class, so acquiring the
+ * lowest free slot of a class is a mask lookup. A slot is taken from the moment it is
+ * acquired or a part is seen in it, and goes back to the allocator when its part is picked.
+ */
+class SlotAllocator {
+    public:
+        static constexpr int kRightBins = 0;  // Slots 0-35 (quadrants 1-36)
+        static constexpr int kLeftBins = 1;   // Slots 36-71 (quadrants 37-72)
+
+        /**
+         * @brief Construct an allocator with every slot free
+         *
+         */
+        SlotAllocator();
+
+        /**
+         * @brief Set the slots the floor robot can reach, which are the only ones handed out
+         *
+         * @param floor_reachable Slots in the floor robot's workspace
+         */
+        void set_floor_reachable(const SlotMask& floor_reachable);
+
+        /**
+         * @brief Take a free floor reachable slot, from the preferred side if it has one
+         *
+         * @param preferred_side kRightBins or kLeftBins
+         * @return int Slot (quadrant - 1), -1 if no floor reachable slot is free
+         */
+        int acquire(int preferred_side);
+
+        /**
+         * @brief Mark a slot as taken, called when a part is seen in it
+         *
+         * @param slot Slot (quadrant - 1)
+         */
+        void occupy(int slot);
+
+        /**
+         * @brief Give a slot back, called when its part is picked
+         *
+         * @param slot Slot (quadrant - 1)
+         */
+        void release(int slot);
+
+        /**
+         * @brief Free slots of one side and reachability class
+         *
+         * @param side kRightBins or kLeftBins
+         * @param floor_reachable true for slots in the floor robot's workspace
+         * @return const SlotMask&
+         */
+        const SlotMask& free(int side, bool floor_reachable) const { return free_[side][floor_reachable]; }
+
+    private:
+        static int side_of(int slot) { return slot < BinSlotTable::kSlots / 2 ? kRightBins : kLeftBins; }
+
+        SlotMask floor_reachable_;
+        std::array<std::array<SlotMask, 2>, 2> free_;  // [side][floor reachable]
+};
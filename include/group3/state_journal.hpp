@@ -0,0 +1,239 @@
+/**
+ * @copyright Copyright (c) 2023
+ * @file state_journal.hpp
+ * @author Sanchit Kedia (sanchit@terpmail.umd.edu)
+ * @author Adarsh Malapaka (amalapak@terpmail.umd.edu)
+ * @author Tanmay Haldankar (tanmayh@terpmail.umd.edu)
+ * @author Sahruday Patti (sahruday@umd.edu)
+ * @author Kshitij Karnawat (kshitij@umd.edu)
+ * @brief Memory mapped workcell state journal for ARIAC 2023 (Group 3)
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ *
+ */
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <geometry_msgs/msg/pose.hpp>
+
+/**
+ * @brief Append only journal of workcell state changes in a memory mapped file
+ *
+ * Every change is one fixed size binary record, written into the mapping with its checksum
+ * last, so a record torn by a crash fails its checksum and ends the replay. The mapping is
+ * shared, so records survive a crash of the process (not of the machine). open() replays the
+ * file into State. The journal is compacted when it is full, after a number of records or after
+ * an interval: the current State is written as a new journal next to it, which then replaces
+ * the old one.
+ *
+ * The header carries the start time of the competition the records belong to. start() discards
+ * the records of an earlier competition and stamps the journal with a new one.
+ */
+class StateJournal {
+    public:
+        enum RecordType : uint16_t {
+            kOrderAccepted = 1,  // order_id, a = order type, b = priority, c = size of the serialized order
+            kOrderSubmitted,     // order_id
+            kSlotChanged,        // a = bin quadrant, b = type*10 + color or -1
+            kAgvMoved,           // a = AGV, b = destination
+            kPartPlaced,         // a = AGV, b = tray quadrant, c = type*10 + color, order_id, pose
+            kKitTrayCleared,     // a = AGV
+            kPartRemoved,        // a = AGV, b = tray quadrant
+            kOrderData,          // order_id, a = offset in the serialized order, c = bytes in data
+            kConveyorAnnounced,  // a = parts announced on the conveyor, followed by the parts still on it
+            kConveyorPart,       // a = index, b = type*10 + color
+            kConveyorPartPassed, // a = parts left on the conveyor
+            kSlotAllocated,      // a = bin quadrant taken to drop a conveyor part in
+        };
+
+        /**
+         * @brief One journal record
+         *
+         */
+        struct Record {
+            uint16_t type;
+            uint16_t reserved;
+            int32_t a;
+            int32_t b;
+            int32_t c;
+            int64_t time_ns;     // Wall time the record was written
+            char order_id[16];   // NUL padded
+            union {
+                float pose[7];   // Position x, y, z and orientation x, y, z, w
+                char data[28];   // kOrderData bytes
+            };
+            uint32_t checksum;   // FNV-1a of the bytes before it
+        };
+
+        /**
+         * @brief Order accepted and not submitted yet
+         *
+         */
+        struct OrderEntry {
+            std::string id;
+            int type;
+            bool priority;
+            size_t size;          // Size of the serialized order
+            std::string message;  // Serialized ariac_msgs::msg::Order, shorter than size if a crash cut it
+
+            bool complete() const { return message.size() == size; }
+        };
+
+        /**
+         * @brief Part placed on a kit tray
+         *
+         */
+        struct KitTrayPart {
+            int part_type_clr;
+            std::string order_id;
+            geometry_msgs::msg::Pose pose;
+        };
+
+        /**
+         * @brief Workcell state rebuilt from the journal
+         *
+         */
+        struct State {
+            std::vector<OrderEntry> orders;                   // In acceptance order
+            std::array<int, 72> slots;                        // Bin quadrant q at q - 1, type*10 + color or -1
+            std::map<int, int> agv_destinations;              // AGV -> last destination
+            std::map<std::pair<int, int>, KitTrayPart> kit_tray_parts;  // (AGV, tray quadrant) -> part
+            bool conveyor_announced = false;
+            int conveyor_size = 0;                            // Parts announced on the conveyor
+            std::vector<int> conveyor_parts;                  // Parts still to pass the breakbeam, type*10 + color
+            std::set<int> allocated_slots;                    // Bin quadrants taken for a dropped part not seen yet
+
+            State() { slots.fill(-1); }
+        };
+
+        StateJournal() = default;
+        ~StateJournal();
+        StateJournal(const StateJournal&) = delete;
+        StateJournal& operator=(const StateJournal&) = delete;
+
+        /**
+         * @brief Open or create the journal file and replay it
+         *
+         * @param path Journal file
+         * @param capacity Records the file holds before it is compacted
+         * @return true The journal is open
+         * @return false The file could not be opened or mapped, nothing is journaled
+         */
+        bool open(const std::string& path, size_t capacity = 4096);
+
+        /**
+         * @brief Whether the journal is open
+         *
+         */
+        bool is_open() const { return records_ != nullptr; }
+
+        /**
+         * @brief Compact after a number of records or after an interval with new records, besides when the file is full
+         *
+         * @param records Records written since the last compaction
+         * @param interval Time since the last compaction
+         */
+        void set_compaction(size_t records, std::chrono::seconds interval);
+
+        /**
+         * @brief Start time of the competition the journal belongs to, 0 if it was never stamped
+         *
+         * @return int64_t Nanoseconds
+         */
+        int64_t competition_start() const;
+
+        /**
+         * @brief Discard every record and stamp the journal with a new competition
+         *
+         * @param competition_start_ns Start time of the competition in nanoseconds
+         * @return true The journal was rewritten
+         * @return false It could not be, the state is discarded but not the file
+         */
+        bool start(int64_t competition_start_ns);
+
+        /**
+         * @brief Record an accepted order with its contents
+         *
+         * @param order_id Order ID
+         * @param type Order type
+         * @param priority Priority order
+         * @param message Serialized ariac_msgs::msg::Order, split over kOrderData records
+         */
+        void order_accepted(const std::string& order_id, int type, bool priority, const std::string& message);
+        void order_submitted(const std::string& order_id);
+        void slot_changed(int quadrant, int part_type_clr);
+        void agv_moved(int agv, int destination);
+        void part_placed(int agv, int quadrant, int part_type_clr, const std::string& order_id,
+                         const geometry_msgs::msg::Pose& pose);
+        void part_removed(int agv, int quadrant);
+        void kit_tray_cleared(int agv);
+        void conveyor_announced(int announced, const std::vector<int>& parts);
+        void conveyor_part_passed(int parts_left);
+        void slot_allocated(int quadrant);
+
+        /**
+         * @brief Copy of the current state
+         *
+         * @return State
+         */
+        State state() const;
+
+        /**
+         * @brief Rewrite the journal as the records of the current state
+         *
+         * @return true The journal was compacted
+         * @return false The new file could not be written, the old one is kept
+         */
+        bool compact();
+
+        /**
+         * @brief Number of records in the journal
+         *
+         * @return size_t
+         */
+        size_t size() const;
+
+    private:
+        struct Header {
+            char magic[8];
+            uint32_t version;
+            uint32_t record_size;
+            uint64_t capacity;
+            int64_t competition_start_ns;
+            char reserved[32];
+        };
+
+        static uint32_t checksum(const Record& record);
+        static void apply(const Record& record, State& state);
+        static std::vector<Record> snapshot_records(const State& state);
+        static void order_records(const OrderEntry& order, size_t offset, std::vector<Record>& records);
+
+        void append(Record record);
+        bool map(const std::string& path, size_t capacity);
+        void unmap();
+        bool compact_locked();
+
+        mutable std::mutex mutex_;
+        std::string path_;
+        int fd_ = -1;
+        Header* header_ = nullptr;
+        Record* records_ = nullptr;
+        size_t capacity_ = 0;
+        size_t count_ = 0;
+        int64_t competition_start_ns_ = 0;
+        size_t compact_records_ = 1024;
+        std::chrono::seconds compact_interval_{60};
+        size_t compacted_count_ = 0;  // Records in the journal after the last compaction
+        std::chrono::steady_clock::time_point compacted_at_;
+        State state_;
+};
@@ -5,14 +5,48 @@
 #include <opencv2/imgproc.hpp>
 #include <opencv2/aruco.hpp>
 
+#include <cstdint>
 #include <iostream>
+#include <mutex>
 #include <vector>
 #include <string>
 
+/**
+ * @brief Class to detect the tray IDs on a kitting tray station
+ *
+ * The ArUco dictionary and detector are built once. Detection runs on a small grayscale strip
+ * holding only the three tray marker windows, so the rest of the frame is never converted or
+ * searched. The result of the last frame is cached by its stamp.
+ */
+class TrayDetector {
+    public:
+        /**
+         * @brief Construct a new Tray Detector object
+         *
+         */
+        TrayDetector();
+
+        /**
+         * @brief Method to return detected tray IDs in the image
+         *
+         * @param frame Kitting tray station camera image (BGR)
+         * @param stamp Stamp of the image in nanoseconds, a negative value disables the cache
+         * @return std::vector<int> Tray ID in each of the three tray slots, -1 if empty
+         */
+        std::vector<int> detect(const cv::Mat& frame, int64_t stamp = -1);
+
+    private:
+        cv::aruco::ArucoDetector detector_;
+        cv::Mat strip_;                       // Marker windows on a white background
+        std::vector<int> cached_ids_;
+        int64_t cached_stamp_ = -1;
+        std::mutex mutex_;
+};
+
 /**
  * @brief Function to return detected tray IDs in the image. 
  * 
  * @param frame 
  * @return std::vector<int> 
  */
-std::vector<int> tray_detect(cv::Mat frame);
\ No newline at end of file
+std::vector<int> tray_detect(cv::Mat frame);
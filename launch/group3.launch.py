@@ -16,12 +16,6 @@ def generate_launch_description():
         parameters=generate_parameters()
     )
 
-    part_detector_start = Node(
-        package="group3",
-        executable="part_detector.py",
-        output="screen",
-    )
-
     # MoveIt node
     moveit = IncludeLaunchDescription(
         PythonLaunchDescriptionSource(
@@ -29,4 +23,4 @@ def generate_launch_description():
         )
     )
     # return LaunchDescription([robot_commander, moveit])
-    return LaunchDescription([robot_commander,part_detector_start,moveit])
+    return LaunchDescription([robot_commander,moveit])
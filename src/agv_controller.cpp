@@ -0,0 +1,110 @@
+/**
+ * @copyright Copyright (c) 2023
+ * @file agv_controller.cpp
+ * @author Sanchit Kedia (sanchit@terpmail.umd.edu)
+ * @author Adarsh Malapaka (amalapak@terpmail.umd.edu)
+ * @author Tanmay Haldankar (tanmayh@terpmail.umd.edu)
+ * @author Sahruday Patti (sahruday@umd.edu)
+ * @author Kshitij Karnawat (kshitij@umd.edu)
+ * @brief Implementation of the non-blocking AGV moves for ARIAC 2023 (Group 3)
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ *
+ */
+#include "agv_controller.hpp"
+
+#include <utility>
+
+namespace {
+
+std::shared_future<bool> ready(bool value) {
+    std::promise<bool> promise;
+    promise.set_value(value);
+    return promise.get_future().share();
+}
+
+bool valid_agv(int agv) {
+    return agv >= 1 && agv <= AgvController::kAgvs;
+}
+
+}  // namespace
+
+AgvController::AgvController(WorkspaceReservations& reservations) : reservations_(reservations) {
+    for (auto& agv : agvs_) {
+        agv.last = ready(true);
+    }
+}
+
+AgvController::~AgvController() {
+    for (auto& agv : agvs_) {
+        agv.last.wait();
+    }
+}
+
+std::shared_future<bool> AgvController::move(int agv, int destination, Action action) {
+    if (!valid_agv(agv)) {
+        return ready(false);
+    }
+    pending(agv).wait();
+    reservations_.acquire(WorkspaceReservations::agv_holder(agv), WorkspaceReservations::agv(agv));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Agv& state = agvs_[agv - 1];
+    state.moving = true;
+    state.location = -1;
+    state.last = std::async(std::launch::async, [this, agv, destination, action] {
+        bool moved = false;
+        try {
+            moved = action();
+        } catch (...) {
+            arrive(agv, destination, false);
+            throw;
+        }
+        arrive(agv, destination, moved);
+        return moved;
+    }).share();
+    return state.last;
+}
+
+std::shared_future<bool> AgvController::pending(int agv) const {
+    if (!valid_agv(agv)) {
+        return ready(true);
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    return agvs_[agv - 1].last;
+}
+
+int AgvController::location(int agv) const {
+    if (!valid_agv(agv)) {
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    return agvs_[agv - 1].location;
+}
+
+void AgvController::set_location(int agv, int destination) {
+    if (!valid_agv(agv)) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    agvs_[agv - 1].location = destination;
+}
+
+bool AgvController::moving(int agv) const {
+    if (!valid_agv(agv)) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    return agvs_[agv - 1].moving;
+}
+
+void AgvController::arrive(int agv, int destination, bool moved) {
+    reservations_.release(WorkspaceReservations::agv_holder(agv));
+    std::lock_guard<std::mutex> lock(mutex_);
+    Agv& state = agvs_[agv - 1];
+    state.moving = false;
+    if (moved) {
+        state.location = destination;
+    }
+}
@@ -15,7 +15,7 @@
 
 #include "../include/group3/ariac_competition.hpp"
 
-AriacCompetition::AriacCompetition(std::string node_name): Node(node_name),
+AriacCompetition::AriacCompetition(std::string node_name, const rclcpp::NodeOptions& node_options): Node(node_name, node_options),
   floor_robot_node_(std::make_shared<rclcpp::Node>("floor_robot")),
   ceil_robot_node_(std::make_shared<rclcpp::Node>("ceiling_robot")),
   executor_(std::make_shared<rclcpp::executors::MultiThreadedExecutor>()),
@@ -110,11 +110,11 @@ AriacCompetition::AriacCompetition(std::string node_name): Node(node_name),
         "/ariac/ceiling_robot_gripper_state", rclcpp::QoS(rclcpp::KeepLast(1)).best_effort().durability_volatile(),
         std::bind(&AriacCompetition::ceil_gripper_state_cb, this, std::placeholders::_1), options2);
 
-  right_part_detector_sub_ = this->create_subscription<group3::msg::Parts>(
+  right_part_detector_sub_ = this->create_subscription<group3::msg::BinSlots>(
         "/right_bin_part_detector", rclcpp::SensorDataQoS(),
         std::bind(&AriacCompetition::right_part_detector_cb, this, std::placeholders::_1), options);
 
-  left_part_detector_sub_ = this->create_subscription<group3::msg::Parts>(
+  left_part_detector_sub_ = this->create_subscription<group3::msg::BinSlots>(
         "/left_bin_part_detector", rclcpp::SensorDataQoS(),
         std::bind(&AriacCompetition::left_part_detector_cb, this, std::placeholders::_1), options);
 
@@ -148,6 +148,18 @@ AriacCompetition::AriacCompetition(std::string node_name): Node(node_name),
 
   AddModelsToPlanningScene();
 
+  bin_map.set_floor_reachable(FloorRobotReachableSlots());
+
+  // Journal of the workcell state, replayed after a restart in the same trial once the competition state is known
+  std::string state_journal_path = this->declare_parameter<std::string>("state_journal", "");
+  if (!state_journal_path.empty()) {
+    if (state_journal_.open(state_journal_path)) {
+      state_journal_.set_compaction(1024, std::chrono::seconds(60));
+    } else {
+      RCLCPP_ERROR_STREAM(this->get_logger(), "Unable to open state journal " << state_journal_path);
+    }
+  }
+
   end_competition_timer_ = this->create_wall_timer(
       std::chrono::milliseconds(100),
       std::bind(&AriacCompetition::end_competition_timer_callback, this)); 
@@ -166,6 +178,9 @@ void AriacCompetition::competition_state_cb(const ariac_msgs::msg::CompetitionSt
 
   if (msg->competition_state == ariac_msgs::msg::CompetitionState::READY) {
     if (!competition_started_) {
+      // This node starts the competition, a journal left by an earlier run is discarded
+      CheckJournalCompetition(true);
+
       std::string srv_name = "/ariac/start_competition";
 
       std::shared_ptr<rclcpp::Node> node =
@@ -195,6 +210,9 @@ void AriacCompetition::competition_state_cb(const ariac_msgs::msg::CompetitionSt
         RCLCPP_ERROR_STREAM(this->get_logger(), "Failed to call trigger service");
       }
     }
+  } else if (msg->competition_state >= ariac_msgs::msg::CompetitionState::STARTED) {
+    // Restarted during a trial
+    CheckJournalCompetition(false);
   }
 }
 
@@ -235,181 +253,162 @@ void AriacCompetition::end_competition_timer_callback() {
     }
   }
   
-  else if ((!orders.empty() || !current_order.empty()) && conveyor_parts_flag_) {
+  else if ((!orders.empty() || !order_tasks_.empty() || !finishing_orders_.empty()) && conveyor_parts_flag_) {
     // bool flag;
     // flag = process_order();
     process_order();
   }
-  else if(orders.empty() && current_order.empty() && incomplete_order.empty() && conveyor_parts_flag_){
+  else if(orders.empty() && order_tasks_.empty() && finishing_orders_.empty() && conveyor_parts_flag_){
     submit_orders_ = true;
-    bool is_pump; // Stores whether the part is a pump or not for conveyor belt
-
-    populate_bin_part();
-    // Conveyor belt part detection and picking
-    while (conveyor_parts.size()!=0){
-      if (conveyor_size == conveyor_parts.size()){
-      floor_robot_->setJointValueTarget("linear_actuator_joint", -2.75);
-      floor_robot_->setJointValueTarget("floor_shoulder_pan_joint", 3.14);
-      floor_robot_->setJointValueTarget("floor_shoulder_lift_joint", -0.942478);
-      FloorRobotMovetoTarget();
-      FloorRobotMoveConveyorHome();
-      }
-      while(!breakbeam_status){
-        if (breakbeam2_status){
-          is_pump = true;
-          pump_rgb = conv_rgb_parts_;
-        }
-      }
-      if (breakbeam_status){
-        std::vector<geometry_msgs::msg::Pose> part_pose;
-        group3::msg::Part part_rgb;
-        part_pose = conv_parts_;
-        part_rgb = conv_rgb_parts_;
-        if (is_pump){
-          is_pump = false;
-          FloorRobotPickConvPart(part_pose, pump_rgb);
-        }
-        else {
-          FloorRobotPickConvPart(part_pose, part_rgb);
-        }
-      } 
-    }
+    PickConveyorParts();
   }
 }
 
 void AriacCompetition::order_callback(ariac_msgs::msg::Order::SharedPtr msg) {
-  Orders order(msg->id, msg->type, msg->priority);
-  if(order.IsPriority() == 1) {
-    high_priority_order_ = true;
+  if (!QueueOrder(*msg, this->now().nanoseconds())) {
+    RCLCPP_WARN_STREAM(this->get_logger(), "Order " << msg->id << " is already queued");
+    return;
   }
+  state_journal_.order_accepted(msg->id, msg->type, msg->priority, SerializeOrder(*msg));
+}
+
+bool AriacCompetition::QueueOrder(const ariac_msgs::msg::Order& msg, int64_t announced_ns) {
+  Orders order(msg.id, msg.type, msg.priority);
 
   // Saving KITTING order information
   if (order.GetType() == ariac_msgs::msg::Order::KITTING) {
     std::array<int, 3> part;
     std::vector<std::array<int, 3>> _parts_kit;
     
-    for (unsigned int i = 0; i < msg->kitting_task.parts.size(); i++) {
-      part[0] = msg->kitting_task.parts[i].part.color;
-      part[1] = msg->kitting_task.parts[i].part.type;
-      part[2] = msg->kitting_task.parts[i].quadrant;
+    for (unsigned int i = 0; i < msg.kitting_task.parts.size(); i++) {
+      part[0] = msg.kitting_task.parts[i].part.color;
+      part[1] = msg.kitting_task.parts[i].part.type;
+      part[2] = msg.kitting_task.parts[i].quadrant;
       _parts_kit.push_back(part);
     }
     
-    Kitting kitting_(msg->kitting_task.agv_number, msg->kitting_task.tray_id, 
-                    msg->kitting_task.destination, _parts_kit);
-    order.SetKitting(std::make_shared<Kitting> (kitting_));
+    Kitting kitting_(msg.kitting_task.agv_number, msg.kitting_task.tray_id, 
+                    msg.kitting_task.destination, _parts_kit);
+    order.SetKitting(std::make_shared<Kitting> (std::move(kitting_)));
   }  else if (order.GetType() == ariac_msgs::msg::Order::ASSEMBLY) {
     // Saving ASSEMBLY order information
     std::vector<unsigned int> _agv_numbers;
     
-    for (unsigned int i = 0; i < msg->assembly_task.agv_numbers.size(); i++) {
+    for (unsigned int i = 0; i < msg.assembly_task.agv_numbers.size(); i++) {
       _agv_numbers.push_back(
-      static_cast<int>(msg->assembly_task.agv_numbers.at(i)));
+      static_cast<int>(msg.assembly_task.agv_numbers.at(i)));
     }
     
     Part part;
     std::vector<Part> _parts_assem;
-    for (unsigned int i = 0; i < msg->assembly_task.parts.size(); i++) {
+    for (unsigned int i = 0; i < msg.assembly_task.parts.size(); i++) {
       part.type =
-          msg->assembly_task.parts[i].part.type;
+          msg.assembly_task.parts[i].part.type;
       part.color =
-          msg->assembly_task.parts[i].part.color;
+          msg.assembly_task.parts[i].part.color;
       part.assembled_pose =
-          msg->assembly_task.parts[i].assembled_pose;
+          msg.assembly_task.parts[i].assembled_pose;
       part.install_direction =
-          msg->assembly_task.parts[i].install_direction;
+          msg.assembly_task.parts[i].install_direction;
       _parts_assem.push_back(part);
     }
 
-    Assembly assembly_(_agv_numbers, msg->assembly_task.station, _parts_assem);
-    order.SetAssembly(std::make_shared<Assembly> (assembly_));
+    Assembly assembly_(_agv_numbers, msg.assembly_task.station, _parts_assem);
+    order.SetAssembly(std::make_shared<Assembly> (std::move(assembly_)));
   }  else if (order.GetType() == ariac_msgs::msg::Order::COMBINED) {
     // Saving COMBINED order information
     Part part;
     std::vector<Part> _parts_comb;
 
-    for (unsigned int i = 0; i < msg->combined_task.parts.size(); i++) {
+    for (unsigned int i = 0; i < msg.combined_task.parts.size(); i++) {
       part.type =
-          msg->combined_task.parts[i].part.type;
+          msg.combined_task.parts[i].part.type;
       part.color =
-          msg->combined_task.parts[i].part.color;
+          msg.combined_task.parts[i].part.color;
       part.assembled_pose =
-          msg->combined_task.parts[i].assembled_pose;
+          msg.combined_task.parts[i].assembled_pose;
       part.install_direction =
-          msg->combined_task.parts[i].install_direction;
+          msg.combined_task.parts[i].install_direction;
       _parts_comb.push_back(part);
     }
 
-    Combined combined_(msg->combined_task.station, _parts_comb);
-    order.SetCombined(std::make_shared<Combined> (combined_));
+    Combined combined_(msg.combined_task.station, _parts_comb);
+    order.SetCombined(std::make_shared<Combined> (std::move(combined_)));
   }
 
+  // Priority orders are queued ahead of regular ones, then by announcement time
+  std::string id = order.GetId();
+  bool priority = order.IsPriority();
+  std::vector<int> bill = OrderPartKeys(order);
+  if (!orders.push(std::move(order), id, priority, announced_ns)) {
+    return false;
+  }
   submit_orders_ = false;
-
-  // Insert order based on priority value 
-  if (order.IsPriority() == 0 || orders.size() == 0) {
-    orders.push_back(order);
-  } else if (orders[orders.size() - 1].IsPriority() == 1) {
-    orders.push_back(order);
-  } else {
-    for (unsigned int i = 0; i < orders.size(); i++) {
-      if (orders[i].IsPriority() == 0) {
-        orders.insert(i + orders.begin(), order);
-        break;
-      }
-    }
+  if (priority) {
+    high_priority_order_ = true;
   }
+  ReserveOrderParts(id, priority, bill);
+  return true;
 }
 
-void AriacCompetition::populate_bin_part(){
-  AriacCompetition::setup_map();
-  bin_quadrant_poses = define_poses();
+std::string AriacCompetition::SerializeOrder(const ariac_msgs::msg::Order& msg) {
+  rclcpp::Serialization<ariac_msgs::msg::Order> serialization;
+  rclcpp::SerializedMessage serialized;
+  serialization.serialize_message(&msg, &serialized);
+  const rcl_serialized_message_t& raw = serialized.get_rcl_serialized_message();
+  return std::string(reinterpret_cast<const char*>(raw.buffer), raw.buffer_length);
+}
+
+InventoryReadiness::Stamps AriacCompetition::bin_camera_stamps() {
+  return {right_bins_rgb_camera_frame_.stamp(), left_bins_rgb_camera_frame_.stamp()};
+}
+
+void AriacCompetition::populate_bin_part(const InventoryReadiness::Stamps& newer_than){
   RCLCPP_INFO_STREAM(this->get_logger(), "Bin map setup");
-  while (!right_bins_rgb_camera_received_data && 
-         !left_bins_rgb_camera_received_data) {}
-
-  std::vector<std::vector<int>> right_bin;
-  for (unsigned int i = 0; i < right_parts_.size(); i++) {
-    std::vector<int> right_bin_part;
-    right_bin_part.push_back(right_parts_[i].color);
-    right_bin_part.push_back(right_parts_[i].type);
-    right_bin_part.push_back(right_parts_[i].quad);
-    right_bin.push_back(right_bin_part);
-  }
-  // std::vector<std::vector<int>> right_bin = rightbin(right_bins_rgb_camera_image_);
-  RCLCPP_INFO_STREAM(this->get_logger(), "Bin Right Vector Information populated");
-  // std::vector<std::vector<int>> left_bin = leftbin(left_bins_rgb_camera_image_);
-  std::vector<std::vector<int>> left_bin;
-  for (unsigned int i = 0; i < left_parts_.size(); i++) {
-    std::vector<int> left_bin_part;
-    left_bin_part.push_back(left_parts_[i].color);
-    left_bin_part.push_back(left_parts_[i].type);
-    left_bin_part.push_back(left_parts_[i].quad);
-    left_bin.push_back(left_bin_part);
-  }
-  RCLCPP_INFO_STREAM(this->get_logger(), "Bin Left Vector Information populated");
-  int count_right = 0;
-  int count_left = 0;
-  for (auto part : right_bin){
-    occupied_quadrants.push_back(part[2]);
-    bin_map[part[2]].part_type_clr = (part[1]*10 + part[0]);
-    bin_map[part[2]].part_pose = bin_quadrant_poses[part[2]];
-    count_right++;
-    RCLCPP_INFO_STREAM(this->get_logger(), "Bin Right Information populated with " << bin_map[part[2]].part_type_clr << " " << bin_map[part[2]].part_pose.position.x << " " << part[2]);
-  }
-  RCLCPP_INFO_STREAM(this->get_logger(), "Bin Right Information populated");
-  for (auto part : left_bin){
-    occupied_quadrants.push_back(part[2]);
-    bin_map[part[2]].part_type_clr = (part[1]*10 + part[0]);
-    bin_map[part[2]].part_pose = bin_quadrant_poses[part[2]];
-    count_left++;
-    RCLCPP_INFO_STREAM(this->get_logger(), "Bin left Information populated with " << bin_map[part[2]].part_type_clr << " " << bin_map[part[2]].part_pose.position.x << " " << part[2]);
-  }
-  RCLCPP_INFO_STREAM(this->get_logger(), "Bin Left Information populated");
+
+  bool fresh = newer_than[InventoryReadiness::kRightBins] >= 0 || newer_than[InventoryReadiness::kLeftBins] >= 0;
+  // Without stamps wait up to 10 s for the first detections, a silent camera must not hang the order thread
+  int waited = 0;
+  while (!inventory_readiness_.wait_newer(newer_than, std::chrono::milliseconds(1000))) {
+    if (fresh) {
+      RCLCPP_WARN_STREAM(this->get_logger(), "No fresh bin part detection, using the last one");
+      break;
+    }
+    if (++waited >= 10) {
+      RCLCPP_WARN_STREAM(this->get_logger(), "No bin part detection after " << waited << " s, bin cameras may not be publishing");
+      break;
+    }
+    RCLCPP_INFO_STREAM(this->get_logger(), "Waiting for bin part detections");
+  }
+
+  group3::msg::BinSlots::ConstSharedPtr right_slots;
+  group3::msg::BinSlots::ConstSharedPtr left_slots;
+  {
+    std::lock_guard<std::mutex> lock(bin_parts_mutex_);
+    right_slots = right_slots_;
+    left_slots = left_slots_;
+  }
+
+  int count_right = CopyBinSlots(right_slots);
+  RCLCPP_INFO_STREAM(this->get_logger(), "Bin Right Information populated with " << count_right << " parts");
+  int count_left = CopyBinSlots(left_slots);
+  RCLCPP_INFO_STREAM(this->get_logger(), "Bin Left Information populated with " << count_left << " parts");
+  CellSnapshot snapshot = RefreshCellSnapshot();
+  // New stock may cover the shortages of accepted orders, including parts a priority order took over
+  int reserved = reservation_ledger_.retry(snapshot.bins(), snapshot.conveyor(), snapshot.kit_trays().reusable_parts());
+  if (reserved > 0) {
+    RCLCPP_INFO_STREAM(this->get_logger(), "Reserved " << reserved << " parts orders were short of");
+  }
 }
 
 void AriacCompetition::conveyor_parts_callback(ariac_msgs::msg::ConveyorParts::SharedPtr msg) {
-  
+  // Already restored from the state journal
+  if (conveyor_parts_flag_) {
+    conveyor_parts_subscriber_.reset();
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(conveyor_mutex_);
   for (unsigned int part_idx = 0; part_idx < msg->parts.size(); part_idx++) {
     for (int qty = 0; qty < msg->parts[part_idx].quantity; qty++) {
       conveyor_parts.push_back((msg->parts[part_idx].part.type)*10 + (msg->parts[part_idx].part.color));
@@ -418,6 +417,10 @@ void AriacCompetition::conveyor_parts_callback(ariac_msgs::msg::ConveyorParts::S
   }
 
   RCLCPP_INFO_STREAM(this->get_logger(), "Conveyor Part Information populated: " << conveyor_parts.size());
+  // Before the journal is matched to the competition it may hold the conveyor as it was before a restart
+  if (journal_checked_) {
+    state_journal_.conveyor_announced(conveyor_size, conveyor_parts);
+  }
   conveyor_parts_flag_ = true;
   conveyor_parts_subscriber_.reset();
 }
@@ -447,330 +450,316 @@ void AriacCompetition::submit_order(std::string order_id) {
   if (rclcpp::spin_until_future_complete(node, result) ==
       rclcpp::FutureReturnCode::SUCCESS) {
     RCLCPP_INFO_STREAM(this->get_logger(),"submit_order_client response: " << result.get()->success << " " << result.get()->message);
+    state_journal_.order_submitted(order_id);
   } else {
     RCLCPP_ERROR(this->get_logger(), "Failed to call service submit_order");
   }
 }
 
 bool AriacCompetition::process_order() {
-
-  if (high_priority_order_ == false) {
-      current_order.push_back(orders.at(0));
-      orders.erase(orders.begin());
-      RCLCPP_INFO_STREAM(this->get_logger(), "====================================================");
-      RCLCPP_INFO_STREAM(this->get_logger(), "Doing Task " <<  current_order[0].GetId() << " Priority: "  << std::to_string(current_order[0].IsPriority()));
-      RCLCPP_INFO_STREAM(this->get_logger(), "====================================================");
-      if(current_order[0].GetType() == ariac_msgs::msg::Order::KITTING) {
-        if ( do_kitting(current_order) == true) {
-          submit_order(current_order[0].GetId());
-          current_order.clear();
-          return true;
-        }
-        else {
-          return false;
-        }
-      }
-      else if (current_order[0].GetType() == ariac_msgs::msg::Order::ASSEMBLY) {
-        if ( do_assembly(current_order) == true) {
-          submit_order(current_order[0].GetId());
-          current_order.clear();
-          return true;
-        }
-        else {
-          return false;
-        }
-      }
-      else if (current_order[0].GetType() == ariac_msgs::msg::Order::COMBINED) {
-        if (do_combined(current_order) == true) {
-          submit_order(current_order[0].GetId());
-          current_order.clear();
-          return true;
-        }
-        else {
-          return false;
-        }
-      }
-  } 
-  else if (high_priority_order_ == true){
-    if (current_order.size() != 0) {
-      incomplete_order.push_back(current_order[0]);
-      current_order.clear();
-      current_order.push_back(orders.at(0));
-      orders.erase(orders.begin());
-    } else {
-      current_order.push_back(orders.at(0));
-      orders.erase(orders.begin());
+  for (auto it = finishing_orders_.begin(); it != finishing_orders_.end();) {
+    if (it->second.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+      it++;
+      continue;
+    }
+    std::string order_id = it->first.order().GetId();
+    if (!it->second.get()) {
+      RCLCPP_WARN_STREAM(this->get_logger(), "Order " << order_id << " did not complete");
     }
-    doing_priority = true;
+    submit_order(order_id);
+    reservation_ledger_.release(order_id);
+    it = finishing_orders_.erase(it);
+  }
+
+  // The flag can outlive its order if the order was started before the flag was set
+  if (high_priority_order_ && !orders.front_is_priority()) {
+    high_priority_order_ = false;
+  }
+  if (!orders.empty() && (order_tasks_.empty() || high_priority_order_)) {
+    order_tasks_.emplace_back(orders.pop());
+    high_priority_order_ = false;
     RCLCPP_INFO_STREAM(this->get_logger(), "====================================================");
-    RCLCPP_INFO_STREAM(this->get_logger(), "Doing Task " <<  current_order[0].GetId() << " Priority: "  << std::to_string(current_order[0].IsPriority()));
+    RCLCPP_INFO_STREAM(this->get_logger(), "Doing Task " <<  order_tasks_.back().order().GetId() << " Priority: "  << std::to_string(order_tasks_.back().order().IsPriority()));
     RCLCPP_INFO_STREAM(this->get_logger(), "====================================================");
-    if(current_order[0].GetType() == ariac_msgs::msg::Order::KITTING) {
-      high_priority_order_ = false;
-      if (do_kitting(current_order) == true) {
-        submit_order(current_order[0].GetId());
-        current_order.clear();
-        if (incomplete_order.size() != 0) {
-          current_order.push_back(incomplete_order[0]);
-          incomplete_order.erase(incomplete_order.begin());
-        }
-        doing_priority = false;
-        return true;
-      }
-      else {
-        return false;
-      }
-    }
-    else if (current_order[0].GetType() == ariac_msgs::msg::Order::ASSEMBLY) {
-      high_priority_order_ = false;
-      if ( do_assembly(current_order) == true) {
-        submit_order(current_order[0].GetId());
-        current_order.clear();
-        if (incomplete_order.size() != 0) {
-          current_order.push_back(incomplete_order[0]);
-          incomplete_order.erase(incomplete_order.begin());
-        }
-        doing_priority = false;
-        return true;
-      }
-      else {
-        return false;
+  }
+  if (order_tasks_.empty()) {
+    return false;
+  }
+
+  OrderTask<Orders>& task = order_tasks_.back();
+  if (task.resume()) {
+    RCLCPP_INFO_STREAM(this->get_logger(), "Resuming Task " << task.order().GetId() << " at stage " << OrderTask<Orders>::stage_name(task.stage()) << ", item " << task.item());
+    populate_bin_part(bin_camera_stamps());
+  }
+
+  bool complete = false;
+  if (task.order().GetType() == ariac_msgs::msg::Order::KITTING) {
+    complete = do_kitting(task);
+  }
+  else if (task.order().GetType() == ariac_msgs::msg::Order::ASSEMBLY) {
+    complete = do_assembly(task);
+  }
+  else if (task.order().GetType() == ariac_msgs::msg::Order::COMBINED) {
+    complete = do_combined(task);
+  }
+  if (!complete) {
+    // Suspended at a checkpoint, the next call starts the priority order on top of it
+    return false;
+  }
+  if (task.stage() == OrderTask<Orders>::Stage::kAssemble) {
+    StartAssembly(std::move(task));
+    order_tasks_.pop_back();
+    return true;
+  }
+  if (task.order().GetType() == ariac_msgs::msg::Order::KITTING) {
+    // Submitted once the AGV reaches its destination, the floor robot starts the next order meanwhile
+    std::shared_future<bool> arrived = agvs_.pending(task.order().GetKitting().get()->GetAgvId());
+    finishing_orders_.emplace_back(std::move(task), arrived);
+    order_tasks_.pop_back();
+    return true;
+  }
+
+  std::string order_id = task.order().GetId();
+  submit_order(order_id);
+  reservation_ledger_.release(order_id);
+  order_tasks_.pop_back();
+  return true;
+}
+
+bool AriacCompetition::SuspendForPriorityOrder(OrderTask<Orders>& task) {
+  if (!high_priority_order_) {
+    return false;
+  }
+  task.suspend();
+  RCLCPP_INFO_STREAM(this->get_logger(), "Suspending Task " << task.order().GetId() << " at stage " << OrderTask<Orders>::stage_name(task.stage()) << ", item " << task.item());
+  return true;
+}
+
+void AriacCompetition::PickConveyorParts() {
+  // The conveyor parts are placed in both bins, the floor robot may change its gripper at the kit tray tables first
+  WorkspaceReservations::AreaMask areas = WorkspaceReservations::area(WorkspaceReservations::kConveyor) |
+                                          WorkspaceReservations::area(WorkspaceReservations::kRightBins) |
+                                          WorkspaceReservations::area(WorkspaceReservations::kLeftBins) |
+                                          WorkspaceReservations::area(WorkspaceReservations::kTrayTables);
+  arms_.run(DualArmExecutor::Arm::kFloor, areas, [this] {
+    bool is_pump = false; // Stores whether the part is a pump or not for conveyor belt
+
+    populate_bin_part();
+    // Conveyor belt part detection and picking, the conveyor state is only touched with conveyor_mutex_ held
+    std::unique_lock<std::mutex> lock(conveyor_mutex_);
+    while (conveyor_parts.size()!=0){
+      if (conveyor_size == static_cast<int>(conveyor_parts.size())){
+      lock.unlock();
+      floor_robot_->setJointValueTarget("linear_actuator_joint", -2.75);
+      floor_robot_->setJointValueTarget("floor_shoulder_pan_joint", 3.14);
+      floor_robot_->setJointValueTarget("floor_shoulder_lift_joint", -0.942478);
+      FloorRobotMovetoTarget();
+      FloorRobotMoveConveyorHome();
+      lock.lock();
       }
-    }
-    else if (current_order[0].GetType() == ariac_msgs::msg::Order::COMBINED) {
-      high_priority_order_ = false;
-      if ( do_combined(current_order) == true) {
-        submit_order(current_order[0].GetId());
-        current_order.clear();
-        if (incomplete_order.size() != 0) {
-          current_order.push_back(incomplete_order[0]);
-          incomplete_order.erase(incomplete_order.begin());
+      // Wait for a part at breakbeam_0, a part seen at breakbeam_2 on the way is a pump
+      bool arrived = conveyor_cv_.wait_for(lock, std::chrono::seconds(60), [this, &is_pump] {
+        if (!breakbeam_status && breakbeam2_status) {
+          is_pump = true;
+          pump_rgb = conv_rgb_parts_;
         }
-        doing_priority = false;
-        return true;
-      }
-      else {
+        return breakbeam_status.load();
+      });
+      if (!arrived) {
+        RCLCPP_WARN_STREAM(this->get_logger(), "No conveyor part reached the breakbeam in 60 s, " << conveyor_parts.size() << " parts left");
         return false;
       }
+      std::vector<geometry_msgs::msg::Pose> part_pose = conv_parts_;
+      group3::msg::Part part_rgb = is_pump ? pump_rgb : conv_rgb_parts_;
+      is_pump = false;
+      lock.unlock();
+      FloorRobotPickConvPart(part_pose, part_rgb);
+      lock.lock();
     }
-  }
+    return true;
+  });
 }
 
-bool AriacCompetition::do_kitting(std::vector<Orders> current_order) {
+std::vector<int> AriacCompetition::ConveyorParts() {
+  std::lock_guard<std::mutex> lock(conveyor_mutex_);
+  return conveyor_parts;
+}
+
+bool AriacCompetition::do_kitting(OrderTask<Orders>& task) {
+  using Stage = OrderTask<Orders>::Stage;
+  const Orders& order = task.order();
   int type_color_key;  // Stores the key of the specific part in the bin map
   int type_color_key_replacement;  // Stores the key of the specific part in the bin map
   int type_color_key_missing;  // Stores the key of the specific part in the bin map
   std::vector<std::array<int, 2>> keys; // Stores the key of the specific part in the bin map and whether it is present or not
-  std::vector<std::array<int, 2>> keys_dropped; // Stores the key of the specific part that has been dropped in the bin map and whether it is present or not
   int type_color;   // Stores type and color info: For ex: 101 -> Battery Green
-  bool is_pump; // Stores whether the part is a pump or not for conveyor belt
-
-  populate_bin_part();
-  // Conveyor belt part detection and picking
-  while (conveyor_parts.size()!=0){
-    if (conveyor_size == conveyor_parts.size()){
-    floor_robot_->setJointValueTarget("linear_actuator_joint", -2.75);
-    floor_robot_->setJointValueTarget("floor_shoulder_pan_joint", 3.14);
-    floor_robot_->setJointValueTarget("floor_shoulder_lift_joint", -0.942478);
-    FloorRobotMovetoTarget();
-    FloorRobotMoveConveyorHome();
-    }
-    while(!breakbeam_status){
-      if (breakbeam2_status){
-        is_pump = true;
-        pump_rgb = conv_rgb_parts_;
-      }
-    }
-    if (breakbeam_status){
-      std::vector<geometry_msgs::msg::Pose> part_pose;
-      group3::msg::Part part_rgb;
-      part_pose = conv_parts_;
-      part_rgb = conv_rgb_parts_;
-      if (is_pump){
-        is_pump = false;
-        FloorRobotPickConvPart(part_pose, pump_rgb);
-      }
-      else {
-        FloorRobotPickConvPart(part_pose, part_rgb);
-      }
-    } 
+  KitTrayModel::Location tray_part;  // Kit tray quadrant of a part placed for another order
+
+  if (task.stage() == Stage::kConveyor) {
+    PickConveyorParts();
+    FloorRobotMoveHome();
+    task.finish_stage(Stage::kTray);
   }
 
-  FloorRobotMoveHome();
-  CeilRobotMoveHome();
-  if (high_priority_order_){
-    process_order();
+  if (task.stage() == Stage::kTray) {
+    if (SuspendForPriorityOrder(task)) {
+      return false;
+    }
+    FloorRobotTransferTray(order.GetKitting().get()->GetTrayId(),order.GetKitting().get()->GetAgvId());
     populate_bin_part();
+    task.finish_stage(Stage::kParts);
   }
-  FloorRobotPickandPlaceTray(current_order[0].GetKitting().get()->GetTrayId(),current_order[0].GetKitting().get()->GetAgvId());
-  populate_bin_part();
 
-  int count = 0;
-  for (unsigned int j =0; j<current_order[0].GetKitting().get()->GetParts().size(); j++){
-    if (high_priority_order_){
-      process_order();
-      populate_bin_part();
+  std::vector<int> part_keys = OrderPartKeys(order);
+  while (task.stage() == Stage::kParts) {
+    if (task.item() == part_keys.size()) {
+      pick_sequencer_.forget(order.GetId());
+      task.finish_stage(Stage::kQualityCheck);
+      break;
+    }
+    if (SuspendForPriorityOrder(task)) {
+      return false;
     }
-    type_color = (current_order[0].GetKitting().get()->GetParts()[j][1]*10 + current_order[0].GetKitting().get()->GetParts()[j][0]);
-    type_color_key = search_bin(type_color);
+    // Parts are picked in the order and from the slots that minimize rail and gantry travel
+    PickStep step = PlanKitPicks(order.GetId(), part_keys, task.item(), order.GetKitting().get()->GetAgvId()).steps[task.item()];
+    unsigned int j = step.part;
+    type_color = part_keys[j];
+    type_color_key = step.quadrant;
     RCLCPP_INFO_STREAM(this->get_logger(), "Type Color Key: " << std::to_string(type_color_key));
     if(type_color_key != -1){
       // 1 denotes part found in Bin
       keys.push_back({type_color_key, 1});
-    } else if(doing_priority = true && type_color_key== -1 && incomplete_order[0].GetType() == ariac_msgs::msg::Order::KITTING){
-      if(partsonkittray.find(type_color) == partsonkittray.end()) {
-        type_color_key = -1;
-        keys.push_back({type_color_key, 0});
-      }
-      else {
-        type_color_key = type_color;
-        keys.push_back({type_color_key, 2});
-      }
+    } else if ((tray_part = kit_trays_.find(type_color, order.GetId())).valid()) {
+      // 2 denotes part found on the kit tray of another order
+      keys.push_back({tray_part.agv*10 + tray_part.quadrant, 2});
     }
     else {
       RCLCPP_WARN_STREAM(this->get_logger(),"The Missing Part is : " << ConvertPartColorToString(type_color%10) << " " << ConvertPartTypeToString(type_color/10));
-      RCLCPP_WARN_STREAM(this->get_logger(),"This Kitting order has insufficient parts : " << current_order[0].GetId());
+      RCLCPP_WARN_STREAM(this->get_logger(),"This Kitting order has insufficient parts : " << order.GetId());
       // 0 denotes part not found anywhere
       keys.push_back({type_color_key, 0});
     }
     for (auto i : keys){
       if (i[1] == 0) {
-        count++;
         continue;
       } else if (i[1] == 1) {
           RCLCPP_INFO_STREAM(this->get_logger(),"Picking Part " << ConvertPartColorToString(bin_map[i[0]].part_type_clr%10) << " " << ConvertPartTypeToString(bin_map[i[0]].part_type_clr/10));
           if (FloorRobotReachableWorkspace(i[0])) {
-            CeilRobotMoveHome();
-            FloorRobotPickBinPart((bin_map[i[0]].part_type_clr)%10,(bin_map[i[0]].part_type_clr)/10, bin_map[i[0]].part_pose, i[0]);
-            FloorRobotPlacePartOnKitTray(current_order[0].GetKitting().get()->GetAgvId(),current_order[0].GetKitting().get()->GetParts()[count][2]);
+            FloorRobotTransferBinPart(i[0], order.GetKitting().get()->GetAgvId(),order.GetKitting().get()->GetParts()[j][2]);
             if(traypartpose.position.x != -1000) {
-              partsonkittray[type_color] = traypartpose;
+              RecordKitTrayPart(order.GetKitting().get()->GetAgvId(), order.GetKitting().get()->GetParts()[j][2], type_color);
             }
           } else {
             // Implement Ceiling Robot FlipPart() later
-            FloorRobotMoveHome();
-            CeilRobotPickBinPart((bin_map[i[0]].part_type_clr)%10,(bin_map[i[0]].part_type_clr)/10, bin_map[i[0]].part_pose, i[0]); 
-            CeilRobotPlacePartOnKitTray(current_order[0].GetKitting().get()->GetAgvId(),current_order[0].GetKitting().get()->GetParts()[count][2]); 
+            CeilRobotTransferBinPart(i[0], order.GetKitting().get()->GetAgvId(),order.GetKitting().get()->GetParts()[j][2]);
           }
-          bin_map[i[0]].part_type_clr = -1;
+          ConsumeBinPart(i[0]);
           // Check if the part is dropped and if yes, then pick the replacement part
           if (dropped_parts_.size() != 0) {
             for (auto part : keys){
-              bin_map[part[0]].part_type_clr = -1;
+              if (part[1] == 1) {
+                UpdateBinPart(part[0], -1);
+              }
             }
             for (auto i : dropped_parts_) {
               type_color_key_replacement = search_bin(i.type*10 + i.color);
               if (type_color_key_replacement == -1) {
                 break;
               }
+              RCLCPP_INFO_STREAM(this->get_logger(),"Picking Replacement Part " << ConvertPartColorToString(i.color) << " " << ConvertPartTypeToString(i.type));
               if (FloorRobotReachableWorkspace(type_color_key_replacement)) {
-                CeilRobotMoveHome();
-                RCLCPP_INFO_STREAM(this->get_logger(),"Picking Replacement Part " << ConvertPartColorToString(i.color) << " " << ConvertPartTypeToString(i.type));
-                FloorRobotPickBinPart(i.color,i.type, bin_map[type_color_key_replacement].part_pose, type_color_key_replacement);
-                FloorRobotPlacePartOnKitTray(current_order[0].GetKitting().get()->GetAgvId(),current_order[0].GetKitting().get()->GetParts()[count][2]);
+                FloorRobotTransferBinPart(type_color_key_replacement, order.GetKitting().get()->GetAgvId(),order.GetKitting().get()->GetParts()[j][2]);
                 if(traypartpose.position.x != -1000) {
-                  partsonkittray[type_color] = traypartpose;
+                  RecordKitTrayPart(order.GetKitting().get()->GetAgvId(), order.GetKitting().get()->GetParts()[j][2], type_color);
                 }
               } else {
-                FloorRobotMoveHome();
-                RCLCPP_INFO_STREAM(this->get_logger(),"Picking Replacement Part " << ConvertPartColorToString(i.color) << " " << ConvertPartTypeToString(i.type));
-                CeilRobotPickBinPart(i.color,i.type, bin_map[type_color_key_replacement].part_pose, type_color_key_replacement);
-                CeilRobotPlacePartOnKitTray(current_order[0].GetKitting().get()->GetAgvId(),current_order[0].GetKitting().get()->GetParts()[count][2]); 
+                CeilRobotTransferBinPart(type_color_key_replacement, order.GetKitting().get()->GetAgvId(),order.GetKitting().get()->GetParts()[j][2]);
               }
-              bin_map[type_color_key_replacement].part_type_clr = -1;
+              ConsumeBinPart(type_color_key_replacement);
             }
             dropped_parts_.clear();
-            populate_bin_part();
+            populate_bin_part(bin_camera_stamps());
           }
       }
       else if (i[1] == 2) {
-        FloorRobotPickTrayPart((i[0])%10,(i[0])/10, partsonkittray[i[0]],incomplete_order[0].GetKitting().get()->GetAgvId());
-        FloorRobotPlacePartOnKitTray(current_order[0].GetKitting().get()->GetAgvId(),current_order[0].GetKitting().get()->GetParts()[count][2]);
+        int tray_part_type_clr = FloorRobotTransferTrayPart(i[0], order.GetKitting().get()->GetAgvId(),order.GetKitting().get()->GetParts()[j][2]);
+        if(traypartpose.position.x != -1000) {
+          RecordKitTrayPart(order.GetKitting().get()->GetAgvId(), order.GetKitting().get()->GetParts()[j][2], tray_part_type_clr);
+        }
       }
-      count++;
     }
     keys.clear();
+    task.finish_item();
   }
 
-  if (high_priority_order_){
-    process_order();
-    populate_bin_part();
-  }
-  // Final Quality Check for the Kitting Order to check if any part is missing
-  auto QualityCheck = CheckFaultyPart(current_order[0].GetId());
-  usleep(2000);
-  QualityCheck = CheckFaultyPart(current_order[0].GetId());
-  if(!QualityCheck[1]){
-    populate_bin_part();
-    for (unsigned int j =0; j<current_order[0].GetKitting().get()->GetParts().size(); j++){
-      if(QualityCheck[4+(j*6)]){
-        type_color_key_missing = search_bin(current_order[0].GetKitting().get()->GetParts()[j][1]*10+current_order[0].GetKitting().get()->GetParts()[j][0]);
-        if (type_color_key_missing != -1) {
-          RCLCPP_INFO_STREAM(this->get_logger(),"Picking Replacement Missing Part " << ConvertPartColorToString((bin_map[type_color_key_missing].part_type_clr)%10) << " " << ConvertPartTypeToString((bin_map[type_color_key_missing].part_type_clr)/10));
-          FloorRobotPickBinPart((bin_map[type_color_key_missing].part_type_clr)%10,(bin_map[type_color_key_missing].part_type_clr)/10, bin_map[type_color_key_missing].part_pose, type_color_key_missing);
-          FloorRobotPlacePartOnKitTray(current_order[0].GetKitting().get()->GetAgvId(),current_order[0].GetKitting().get()->GetParts()[j][2]);
+  if (task.stage() == Stage::kQualityCheck) {
+    if (SuspendForPriorityOrder(task)) {
+      return false;
+    }
+    // Final Quality Check for the Kitting Order to check if any part is missing
+    auto QualityCheck = CheckFaultyPart(order.GetId());
+    usleep(2000);
+    QualityCheck = CheckFaultyPart(order.GetId());
+    RecordKitTrayQuality(order.GetKitting().get()->GetAgvId(), QualityCheck);
+    if(!QualityCheck[1]){
+      populate_bin_part();
+      for (unsigned int j =0; j<order.GetKitting().get()->GetParts().size(); j++){
+        if(QualityCheck[4+(j*6)]){
+          type_color_key_missing = search_bin(order.GetKitting().get()->GetParts()[j][1]*10+order.GetKitting().get()->GetParts()[j][0]);
+          if (type_color_key_missing != -1) {
+            RCLCPP_INFO_STREAM(this->get_logger(),"Picking Replacement Missing Part " << ConvertPartColorToString((bin_map[type_color_key_missing].part_type_clr)%10) << " " << ConvertPartTypeToString((bin_map[type_color_key_missing].part_type_clr)/10));
+            FloorRobotTransferBinPart(type_color_key_missing, order.GetKitting().get()->GetAgvId(),order.GetKitting().get()->GetParts()[j][2]);
+            ConsumeBinPart(type_color_key_missing);
+            if(traypartpose.position.x != -1000) {
+              RecordKitTrayPart(order.GetKitting().get()->GetAgvId(), order.GetKitting().get()->GetParts()[j][2], order.GetKitting().get()->GetParts()[j][1]*10+order.GetKitting().get()->GetParts()[j][0]);
+            }
+          }
         }
       }
     }
-  }
 
-
-  int used_agv = current_order[0].GetKitting().get()->GetAgvId();
-  if (available_agvs.size() > 0) {
-    available_agvs.erase(std::remove(available_agvs.begin(), available_agvs.end(), used_agv), available_agvs.end());
-  }
-  else {
-    RCLCPP_WARN_STREAM(this->get_logger(),"No more AGVs available!");
+    int used_agv = order.GetKitting().get()->GetAgvId();
+    if (available_agvs.size() > 0) {
+      available_agvs.erase(std::remove(available_agvs.begin(), available_agvs.end(), used_agv), available_agvs.end());
+    }
+    else {
+      RCLCPP_WARN_STREAM(this->get_logger(),"No more AGVs available!");
+    }
+    task.finish_stage(Stage::kMoveAgv);
   }
 
-  if (high_priority_order_){
-    process_order();
+  if (task.stage() == Stage::kMoveAgv) {
+    if (SuspendForPriorityOrder(task)) {
+      return false;
+    }
+    DispatchAgv(order.GetKitting().get()->GetAgvId(), order.GetKitting().get()->GetDestination(), false);
+    task.finish_stage(Stage::kDone);
   }
-  move_agv(current_order[0].GetKitting().get()->GetAgvId(), current_order[0].GetKitting().get()->GetDestination());
   FloorRobotMoveHome();
-  CeilRobotMoveHome();
-  partsonkittray.clear();
   RCLCPP_INFO_STREAM(this->get_logger(),"Kitting Order Completed");
   return true;
 }
 
-bool AriacCompetition::do_assembly(std::vector<Orders>  current_order) {
+bool AriacCompetition::do_assembly(OrderTask<Orders>& task) {
+  using Stage = OrderTask<Orders>::Stage;
+  const Orders& order = task.order();
+  int station_num = order.GetAssembly().get()->GetStation();
+  std::vector<unsigned int> agv_numbers = order.GetAssembly().get()->GetAgvNumbers();
 
-  bool is_pump; // Stores whether the part is a pump or not for conveyor belt
+  if (task.stage() == Stage::kConveyor) {
+    PickConveyorParts();
+    task.finish_stage(Stage::kMoveAgv);
+  }
 
-  populate_bin_part();
-  // Conveyor belt part detection and picking
-  while (conveyor_parts.size()!=0){
-    if (conveyor_size == conveyor_parts.size()){
-    floor_robot_->setJointValueTarget("linear_actuator_joint", -2.75);
-    floor_robot_->setJointValueTarget("floor_shoulder_pan_joint", 3.14);
-    floor_robot_->setJointValueTarget("floor_shoulder_lift_joint", -0.942478);
-    FloorRobotMovetoTarget();
-    FloorRobotMoveConveyorHome();
+  while (task.stage() == Stage::kMoveAgv) {
+    if (task.item() == agv_numbers.size()) {
+      task.finish_stage(Stage::kAssemble);
+      break;
     }
-    while(!breakbeam_status){
-      if (breakbeam2_status){
-        is_pump = true;
-        pump_rgb = conv_rgb_parts_;
-      }
+    if (SuspendForPriorityOrder(task)) {
+      return false;
     }
-    if (breakbeam_status){
-      std::vector<geometry_msgs::msg::Pose> part_pose;
-      group3::msg::Part part_rgb;
-      part_pose = conv_parts_;
-      part_rgb = conv_rgb_parts_;
-      if (is_pump){
-        is_pump = false;
-        FloorRobotPickConvPart(part_pose, pump_rgb);
-      }
-      else {
-        FloorRobotPickConvPart(part_pose, part_rgb);
-      }
-    } 
-  }
-  int station_num = current_order[0].GetAssembly().get()->GetStation();
-
-  for (auto agv_num : current_order[0].GetAssembly().get()->GetAgvNumbers()) {
+    int agv_num = agv_numbers[task.item()];
     int destination;
     if (station_num == ariac_msgs::msg::AssemblyTask::AS1 || station_num == ariac_msgs::msg::AssemblyTask::AS3)
     {
@@ -781,9 +770,8 @@ bool AriacCompetition::do_assembly(std::vector<Orders>  current_order) {
       destination = ariac_msgs::srv::MoveAGV::Request::ASSEMBLY_BACK;
     }
 
-    lock_agv(agv_num);
-    move_agv(agv_num, destination);
-    unlock_agv(agv_num);
+    // Every AGV is dispatched at once, the ceiling robot waits for them at the station
+    DispatchAgv(agv_num, destination, true);
     int used_agv = agv_num;
     if (available_agvs.size() > 0) {
         available_agvs.erase(std::remove(available_agvs.begin(), available_agvs.end(), used_agv), available_agvs.end());
@@ -791,271 +779,175 @@ bool AriacCompetition::do_assembly(std::vector<Orders>  current_order) {
     else {
         RCLCPP_WARN_STREAM(this->get_logger(),"No more AGVs available!");
     }
+    task.finish_item();
   }
 
-  CeilRobotMoveToAssemblyStation(station_num);
-  if (high_priority_order_){
-    process_order();
-    CeilRobotMoveToAssemblyStation(station_num);
-  }
-
-  std::string srv_name = "/ariac/get_pre_assembly_poses";
-
-  std::shared_ptr<rclcpp::Node> node = rclcpp::Node::make_shared("get_pre_assembly_poses");
-  rclcpp::Client<ariac_msgs::srv::GetPreAssemblyPoses>::SharedPtr pre_assembly_poses_getter_ = node->create_client<ariac_msgs::srv::GetPreAssemblyPoses>(srv_name);
-
-  auto request = std::make_shared<ariac_msgs::srv::GetPreAssemblyPoses::Request>();
-  request->order_id = current_order[0].GetId();
-
-  while (!pre_assembly_poses_getter_->wait_for_service(std::chrono::milliseconds(1000))) {
-    if (!rclcpp::ok()) {
-      RCLCPP_ERROR(this->get_logger(), "Interrupted while waiting for the service. Exiting.");
-    }
-    RCLCPP_INFO_STREAM(this->get_logger(), "Service not available, waiting again...");
-  }
-
-  auto result = pre_assembly_poses_getter_->async_send_request(request);
-
-  if (rclcpp::spin_until_future_complete(node, result) == rclcpp::FutureReturnCode::SUCCESS) {
-    RCLCPP_INFO_STREAM(this->get_logger(),"Pre Assembly Poses recieved");
-  } else {
-    RCLCPP_ERROR(this->get_logger(), "Failed to call service get_pre_assembly_poses");
-  }
-
-  std::vector<ariac_msgs::msg::PartPose> agv_part_poses; 
-  if (result.get()->valid_id) {
-    agv_part_poses = result.get()->parts;
-
-    if (agv_part_poses.size() == 0) {
-      RCLCPP_WARN(get_logger(), "No part poses recieved");
-    }
-  } else {
-    RCLCPP_WARN(get_logger(), "Not a valid order ID");
-  }
-
-  for (auto const &part_to_assemble : current_order[0].GetAssembly().get()->GetParts()) {
-    if (high_priority_order_){
-      process_order();
-      CeilRobotMoveToAssemblyStation(station_num);
-    }
-    ariac_msgs::msg::PartPose part_to_pick;
-    part_to_pick.part.type = part_to_assemble.type;
-    part_to_pick.part.color = part_to_assemble.color;
-    for (auto const &agv_part: agv_part_poses) {
-      if (agv_part.part.type == part_to_assemble.type && agv_part.part.color == part_to_assemble.color) {
-        part_to_pick.pose = agv_part.pose;
-        break;
-      }
-    }
-
-    // Pick up part
-    CeilRobotPickAGVPart(part_to_pick);
-
-    CeilRobotMoveToAssemblyStation(station_num);
-    
-    CeilRobotAssemblePart(station_num, part_to_assemble);
-
-    CeilRobotMoveToAssemblyStation(station_num);
-  }
-  CeilRobotMoveHome();
-  RCLCPP_INFO_STREAM(this->get_logger(),"Assembly Order Completed");
+  RCLCPP_INFO_STREAM(this->get_logger(),"Assembly Order AGVs sent to " << ConvertAssemblyStationToString(station_num));
   return true;
 }
 
-bool AriacCompetition::do_combined(std::vector<Orders>  current_order) {
-
-  bool is_pump; // Stores whether the part is a pump or not for conveyor belt
+bool AriacCompetition::do_combined(OrderTask<Orders>& task) {
+  using Stage = OrderTask<Orders>::Stage;
+  const Orders& order = task.order();
   int type_color_key_replacement;  // Stores the key of the specific part in the bin map
+  int station_num = order.GetCombined().get()->GetStation();
 
-  populate_bin_part();
-  // Conveyor belt part detection and picking
-  while (conveyor_parts.size()!=0){
-    if (conveyor_size == conveyor_parts.size()){
-    floor_robot_->setJointValueTarget("linear_actuator_joint", -2.75);
-    floor_robot_->setJointValueTarget("floor_shoulder_pan_joint", 3.14);
-    floor_robot_->setJointValueTarget("floor_shoulder_lift_joint", -0.942478);
-    FloorRobotMovetoTarget();
-    FloorRobotMoveConveyorHome();
-    }
-    while(!breakbeam_status){
-      if (breakbeam2_status){
-        is_pump = true;
-        pump_rgb = conv_rgb_parts_;
+  if (task.stage() == Stage::kConveyor) {
+    PickConveyorParts();
+    task.finish_stage(Stage::kTray);
+  }
+
+  if (task.stage() == Stage::kTray) {
+    // The AGV is chosen once, a resumed order keeps it
+    if (task.agv() == -1) {
+      int agv_num;
+      if (station_num == ariac_msgs::msg::CombinedTask::AS1 or station_num == ariac_msgs::msg::CombinedTask::AS2) {
+        if (std::find(available_agvs.begin(), available_agvs.end(), 1) != available_agvs.end()) {
+          agv_num = 1;
+        } else {
+          agv_num = 2;
+        }  
+      } else {
+        if (std::find(available_agvs.begin(), available_agvs.end(), 4) != available_agvs.end()) {
+          agv_num = 4;
+        } else {
+          agv_num = 3;
+        } 
       }
-    }
-    if (breakbeam_status){
-      std::vector<geometry_msgs::msg::Pose> part_pose;
-      group3::msg::Part part_rgb;
-      part_pose = conv_parts_;
-      part_rgb = conv_rgb_parts_;
-      if (is_pump){
-        is_pump = false;
-        FloorRobotPickConvPart(part_pose, pump_rgb);
+
+      int used_agv = agv_num;
+      if (available_agvs.size() > 0) {
+        available_agvs.erase(std::remove(available_agvs.begin(), available_agvs.end(), used_agv), available_agvs.end());
       }
       else {
-        FloorRobotPickConvPart(part_pose, part_rgb);
+        RCLCPP_WARN_STREAM(this->get_logger(),"No more AGVs available!");
       }
-    } 
-  }
-
-  int agv_num;
-  int station_num = current_order[0].GetCombined().get()->GetStation();
-
-  if (station_num == ariac_msgs::msg::CombinedTask::AS1 or station_num == ariac_msgs::msg::CombinedTask::AS2) {
-    if (std::find(available_agvs.begin(), available_agvs.end(), 1) != available_agvs.end()) {
-      agv_num = 1;
-    } else {
-      agv_num = 2;
-    }  
-  } else {
-    if (std::find(available_agvs.begin(), available_agvs.end(), 4) != available_agvs.end()) {
-      agv_num = 4;
-    } else {
-      agv_num = 3;
-    } 
-  }
-
-  if (doing_priority == false){
-    old_agv = agv_num;
-  }
-
-  int used_agv = agv_num;
-  if (available_agvs.size() > 0) {
-    available_agvs.erase(std::remove(available_agvs.begin(), available_agvs.end(), used_agv), available_agvs.end());
-  }
-  else {
-    RCLCPP_WARN_STREAM(this->get_logger(),"No more AGVs available!");
+      task.set_agv(agv_num);
+
+      int tray_num = 0;
+
+      CameraFrame kts1_frame = kts1_rgb_camera_frame_.latest();
+      CameraFrame kts2_frame = kts2_rgb_camera_frame_.latest();
+      auto kts1_vec = kts1_tray_detector_.detect(kts1_frame.bgr, kts1_frame.stamp);
+      auto kts2_vec = kts2_tray_detector_.detect(kts2_frame.bgr, kts2_frame.stamp);
+      std::vector<int> tray_id_vec(kts1_vec);
+      tray_id_vec.insert(tray_id_vec.end(), kts2_vec.begin(), kts2_vec.end());
+
+      RCLCPP_INFO_STREAM(this->get_logger(),"Use AGV " << agv_num << " and Tray ID " << tray_num);
+        
+      FloorRobotMoveHome();
+      // The ceiling robot heads to the station while the floor robot kits
+      arms_.submit(DualArmExecutor::Arm::kCeiling, WorkspaceReservations::station(station_num), [this, station_num] {
+        return CeilRobotMoveToAssemblyStation(station_num);
+      });
+    }
+    if (SuspendForPriorityOrder(task)) {
+      return false;
+    }
+    FloorRobotTransferTray(0, task.agv());
+    task.finish_stage(Stage::kParts);
   }
 
-  int tray_num = 0;
-
-  auto kts1_vec = tray_detect(kts1_rgb_camera_image_);
-  auto kts2_vec = tray_detect(kts2_rgb_camera_image_);
-  std::vector<int> tray_id_vec(kts1_vec);
-  tray_id_vec.insert(tray_id_vec.end(), kts2_vec.begin(), kts2_vec.end());
-  
-  std::string part_info;
-
-  RCLCPP_INFO_STREAM(this->get_logger(),"Use AGV " << agv_num << " and Tray ID " << tray_num);
-    
-  FloorRobotMoveHome();
-  CeilRobotMoveToAssemblyStation(station_num);
-  if (high_priority_order_){
-    process_order();
-    populate_bin_part();
-  }
-  FloorRobotPickandPlaceTray(tray_num, agv_num);
-  
-  int type_color_key;
-  std::vector<std::array<int, 2>> keys;
-  int type_color;
-  
-  int count = 0;
+  int agv_num = task.agv();
   std::array<int,4> quadrant = {1,2,3,4};
-  for (unsigned int j = 0; j < current_order[0].GetCombined().get()->GetParts().size(); j++){
-    if (high_priority_order_){
-      process_order();
-      populate_bin_part();
+  std::vector<int> part_keys = OrderPartKeys(order);
+  while (task.stage() == Stage::kParts) {
+    if (task.item() == part_keys.size()) {
+      pick_sequencer_.forget(order.GetId());
+      task.finish_stage(Stage::kMoveAgv);
+      break;
     }
-    type_color = (current_order[0].GetCombined().get()->GetParts()[j].type*10 + current_order[0].GetCombined().get()->GetParts()[j].color);
-    type_color_key = search_bin(type_color);
+    if (SuspendForPriorityOrder(task)) {
+      return false;
+    }
+    int type_color_key;
+    std::vector<std::array<int, 2>> keys;
+    KitTrayModel::Location tray_part;
+    PickStep step = PlanKitPicks(order.GetId(), part_keys, task.item(), agv_num).steps[task.item()];
+    int type_color = part_keys[step.part];
+    type_color_key = step.quadrant;
     if(type_color_key != -1){
       keys.push_back({type_color_key, 1});
-    }else if(doing_priority = true && type_color_key == -1)  {
-      if(partsonkittray.find(type_color) == partsonkittray.end()) {
-        type_color_key = -1;
-        keys.push_back({type_color_key, 0});
-      }
-      else {
-        type_color_key = type_color;
-        keys.push_back({type_color_key, 2});
-      }
+    } else if ((tray_part = kit_trays_.find(type_color, order.GetId())).valid()) {
+      keys.push_back({tray_part.agv*10 + tray_part.quadrant, 2});
     } 
     for (auto i : keys){
+      int count = task.tray_slot();
       if (i[1] == 0) {
         continue;
       } else if (i[1] == 1) {
-        part_info = ConvertPartColorToString((bin_map[i[0]].part_type_clr)%10) + " " + ConvertPartTypeToString((bin_map[i[0]].part_type_clr)/10);
         if (FloorRobotReachableWorkspace(i[0])) {
-          // CeilRobotMoveHome();
-          FloorRobotPickBinPart((bin_map[i[0]].part_type_clr)%10,(bin_map[i[0]].part_type_clr)/10, bin_map[i[0]].part_pose, i[0]);
-          FloorRobotPlacePartOnKitTray(agv_num,quadrant[count]);
+          FloorRobotTransferBinPart(i[0], agv_num, quadrant[count]);
           if(traypartpose.position.x != -1000) {
-              partsonkittray[type_color] = traypartpose;
+              RecordKitTrayPart(agv_num, quadrant[count], type_color);
           }
         } else {
-          // FloorRobotMoveHome();
-          CeilRobotPickBinPart((bin_map[i[0]].part_type_clr)%10,(bin_map[i[0]].part_type_clr)/10, bin_map[i[0]].part_pose, i[0]); 
-          CeilRobotPlacePartOnKitTray(agv_num,quadrant[count]);
+          CeilRobotTransferBinPart(i[0], agv_num, quadrant[count]);
         }
-        bin_map[i[0]].part_type_clr = -1;
+        ConsumeBinPart(i[0]);
         if (dropped_parts_.size() != 0) {
           for (auto part : keys){
-            bin_map[part[0]].part_type_clr = -1;
+            if (part[1] == 1) {
+              UpdateBinPart(part[0], -1);
+            }
           }
           for (auto i : dropped_parts_) {
             type_color_key_replacement = search_bin(i.type*10 + i.color);
             if (type_color_key_replacement == -1) {
               break;
             }
+            RCLCPP_INFO_STREAM(this->get_logger(),"Picking Replacement Part " << ConvertPartColorToString(i.color) << " " << ConvertPartTypeToString(i.type));
             if (FloorRobotReachableWorkspace(type_color_key_replacement)) {
-              CeilRobotMoveHome();
-              RCLCPP_INFO_STREAM(this->get_logger(),"Picking Replacement Part " << ConvertPartColorToString(i.color) << " " << ConvertPartTypeToString(i.type));
-              FloorRobotPickBinPart(i.color,i.type, bin_map[type_color_key_replacement].part_pose, type_color_key_replacement);
-              FloorRobotPlacePartOnKitTray(agv_num,quadrant[count]);
+              FloorRobotTransferBinPart(type_color_key_replacement, agv_num, quadrant[count]);
               if(traypartpose.position.x != -1000) {
-                partsonkittray[type_color] = traypartpose;
+                RecordKitTrayPart(agv_num, quadrant[count], type_color);
               }
             } else {
-              FloorRobotMoveHome();
-              RCLCPP_INFO_STREAM(this->get_logger(),"Picking Replacement Part " << ConvertPartColorToString(i.color) << " " << ConvertPartTypeToString(i.type));
-              CeilRobotPickBinPart(i.color,i.type, bin_map[type_color_key_replacement].part_pose, type_color_key_replacement);
-              CeilRobotPlacePartOnKitTray(agv_num,quadrant[count]); 
+              CeilRobotTransferBinPart(type_color_key_replacement, agv_num, quadrant[count]);
             }
-            bin_map[type_color_key_replacement].part_type_clr = -1;
+            ConsumeBinPart(type_color_key_replacement);
           }
           dropped_parts_.clear();
-          populate_bin_part();
+          populate_bin_part(bin_camera_stamps());
         }
       } 
       else if (i[1] == 2) {
-        if (incomplete_order[0].GetType() == ariac_msgs::msg::Order::KITTING){
-          FloorRobotPickTrayPart((i[0])%10,(i[0])/10, partsonkittray[i[0]],incomplete_order[0].GetKitting().get()->GetAgvId());
-        }
-        else {
-          FloorRobotPickTrayPart((i[0])%10,(i[0])/10, partsonkittray[i[0]],old_agv);
+        int tray_part_type_clr = FloorRobotTransferTrayPart(i[0], agv_num, quadrant[count]);
+        if(traypartpose.position.x != -1000) {
+          RecordKitTrayPart(agv_num, quadrant[count], tray_part_type_clr);
         }
-        FloorRobotPlacePartOnKitTray(agv_num,quadrant[count]);
       }
-      count++;
+      task.use_tray_slot();
     }
-    keys.clear();
+    task.finish_item();
   }
 
-  int Dest;
-  if (station_num == ariac_msgs::msg::CombinedTask::AS1 or station_num == ariac_msgs::msg::CombinedTask::AS3) {
-    Dest = ariac_msgs::msg::KittingTask::ASSEMBLY_FRONT;
-  } else {
-    Dest = ariac_msgs::msg::KittingTask::ASSEMBLY_BACK;
-  }
-  lock_agv(agv_num);
-  move_agv(agv_num, Dest);
-  FloorRobotMoveHome();
-  CeilRobotMoveToAssemblyStation(station_num);
-  unlock_agv(agv_num);
-
-  if (high_priority_order_){
-    process_order();
-    CeilRobotMoveToAssemblyStation(station_num);
+  if (task.stage() == Stage::kMoveAgv) {
+    if (SuspendForPriorityOrder(task)) {
+      return false;
+    }
+    int Dest;
+    if (station_num == ariac_msgs::msg::CombinedTask::AS1 or station_num == ariac_msgs::msg::CombinedTask::AS3) {
+      Dest = ariac_msgs::msg::KittingTask::ASSEMBLY_FRONT;
+    } else {
+      Dest = ariac_msgs::msg::KittingTask::ASSEMBLY_BACK;
+    }
+    DispatchAgv(agv_num, Dest, true);
+    FloorRobotMoveHome();
+    task.finish_stage(Stage::kAssemble);
   }
+  RCLCPP_INFO_STREAM(this->get_logger(),"Combined Order Kit sent to " << ConvertAssemblyStationToString(station_num));
+  return true;
+}
 
+std::vector<ariac_msgs::msg::PartPose> AriacCompetition::GetPreAssemblyPoses(const std::string& order_id) {
   std::string srv_name = "/ariac/get_pre_assembly_poses";
 
   std::shared_ptr<rclcpp::Node> node = rclcpp::Node::make_shared("get_pre_assembly_poses");
   rclcpp::Client<ariac_msgs::srv::GetPreAssemblyPoses>::SharedPtr pre_assembly_poses_getter_ = node->create_client<ariac_msgs::srv::GetPreAssemblyPoses>(srv_name);
 
   auto request = std::make_shared<ariac_msgs::srv::GetPreAssemblyPoses::Request>();
-  request->order_id = current_order[0].GetId();
+  request->order_id = order_id;
 
   while (!pre_assembly_poses_getter_->wait_for_service(std::chrono::milliseconds(1000))) {
     if (!rclcpp::ok()) {
@@ -1070,6 +962,7 @@ bool AriacCompetition::do_combined(std::vector<Orders>  current_order) {
     RCLCPP_INFO_STREAM(this->get_logger(),"Pre Assembly Poses recieved");
   } else {
     RCLCPP_ERROR(this->get_logger(), "Failed to call service get_pre_assembly_poses");
+    return {};
   }
 
   std::vector<ariac_msgs::msg::PartPose> agv_part_poses; 
@@ -1082,16 +975,26 @@ bool AriacCompetition::do_combined(std::vector<Orders>  current_order) {
   } else {
     RCLCPP_WARN(get_logger(), "Not a valid order ID");
   }
+  return agv_part_poses;
+}
 
-  for (auto const &part_to_assemble : current_order[0].GetCombined().get()->GetParts()) {
-    if (high_priority_order_){
-      process_order();
-      CeilRobotMoveToAssemblyStation(station_num);
+bool AriacCompetition::AssembleOrderParts(OrderTask<Orders>& task, int station_num, const std::vector<Part>& parts, const std::vector<unsigned int>& agv_numbers) {
+  CeilRobotMoveToAssemblyStation(station_num);
+  if (task.item() == 0) {
+    for (unsigned int agv_num : agv_numbers) {
+      if (!agvs_.wait(agv_num)) {
+        RCLCPP_WARN_STREAM(this->get_logger(), "AGV " << agv_num << " did not reach " << ConvertAssemblyStationToString(station_num));
+      }
     }
+    task.set_assembly_poses(GetPreAssemblyPoses(task.order().GetId()));
+  }
+
+  while (task.item() < parts.size()) {
+    const Part& part_to_assemble = parts[task.item()];
     ariac_msgs::msg::PartPose part_to_pick;
     part_to_pick.part.type = part_to_assemble.type;
     part_to_pick.part.color = part_to_assemble.color;
-    for (auto const &agv_part: agv_part_poses) {
+    for (auto const &agv_part: task.assembly_poses()) {
       if (agv_part.part.type == part_to_assemble.type && agv_part.part.color == part_to_assemble.color) {
         part_to_pick.pose = agv_part.pose;
         break;
@@ -1106,27 +1009,404 @@ bool AriacCompetition::do_combined(std::vector<Orders>  current_order) {
     CeilRobotAssemblePart(station_num, part_to_assemble);
 
     CeilRobotMoveToAssemblyStation(station_num);
+    task.finish_item();
   }
   CeilRobotMoveHome();
-  RCLCPP_INFO_STREAM(this->get_logger(),"Combined Order Completed");
+  task.finish_stage(OrderTask<Orders>::Stage::kDone);
+  RCLCPP_INFO_STREAM(this->get_logger(),"Order " << task.order().GetId() << " Assembled");
   return true;
 }
 
+void AriacCompetition::StartAssembly(OrderTask<Orders> task) {
+  int station_num = task.order().GetType() == ariac_msgs::msg::Order::ASSEMBLY ? task.order().GetAssembly().get()->GetStation()
+                                                                                : task.order().GetCombined().get()->GetStation();
+  std::vector<Part> parts = task.order().GetType() == ariac_msgs::msg::Order::ASSEMBLY ? task.order().GetAssembly().get()->GetParts()
+                                                                                       : task.order().GetCombined().get()->GetParts();
+  std::vector<unsigned int> agv_numbers = task.order().GetType() == ariac_msgs::msg::Order::ASSEMBLY ? task.order().GetAssembly().get()->GetAgvNumbers()
+                                                                                                     : std::vector<unsigned int>{static_cast<unsigned int>(task.agv())};
+  // The list node keeps the task in place while the ceiling robot works on it
+  finishing_orders_.emplace_back(std::move(task), std::shared_future<bool>());
+  OrderTask<Orders>& assembly = finishing_orders_.back().first;
+  finishing_orders_.back().second = arms_.submit(DualArmExecutor::Arm::kCeiling, WorkspaceReservations::station(station_num),
+                                                 [this, &assembly, station_num, parts, agv_numbers] {
+    return AssembleOrderParts(assembly, station_num, parts, agv_numbers);
+  }).share();
+  RCLCPP_INFO_STREAM(this->get_logger(),"Order " << assembly.order().GetId() << " handed to the Ceiling Robot for assembly");
+}
+
+void AriacCompetition::FloorRobotTransferTray(int tray_idx, int agv_num) {
+  WorkspaceReservations::AreaMask areas = WorkspaceReservations::area(WorkspaceReservations::kTrayTables) | WorkspaceReservations::agv(agv_num);
+  arms_.run(DualArmExecutor::Arm::kFloor, areas, [this, tray_idx, agv_num] {
+    FloorRobotPickandPlaceTray(tray_idx, agv_num);
+    return true;
+  });
+}
+
+bool AriacCompetition::FloorRobotTransferBinPart(int quadrant, int agv_num, int tray_quadrant) {
+  int part_type_clr = bin_map[quadrant].part_type_clr;
+  geometry_msgs::msg::Pose part_pose = bin_map[quadrant].part_pose;
+  // The floor robot may change its gripper at the kit tray tables on the way
+  WorkspaceReservations::AreaMask areas = WorkspaceReservations::bins(quadrant) | WorkspaceReservations::agv(agv_num) |
+                                          WorkspaceReservations::area(WorkspaceReservations::kTrayTables);
+  return arms_.run(DualArmExecutor::Arm::kFloor, areas, [=] {
+    FloorRobotPickBinPart(part_type_clr%10, part_type_clr/10, part_pose, quadrant);
+    return FloorRobotPlacePartOnKitTray(agv_num, tray_quadrant);
+  });
+}
+
+bool AriacCompetition::CeilRobotTransferBinPart(int quadrant, int agv_num, int tray_quadrant) {
+  int part_type_clr = bin_map[quadrant].part_type_clr;
+  geometry_msgs::msg::Pose part_pose = bin_map[quadrant].part_pose;
+  // The ceiling robot may change its gripper at the kit tray tables on the way
+  WorkspaceReservations::AreaMask areas = WorkspaceReservations::bins(quadrant) | WorkspaceReservations::agv(agv_num) |
+                                          WorkspaceReservations::area(WorkspaceReservations::kTrayTables);
+  return arms_.run(DualArmExecutor::Arm::kCeiling, areas, [=] {
+    CeilRobotPickBinPart(part_type_clr%10, part_type_clr/10, part_pose, quadrant);
+    return CeilRobotPlacePartOnKitTray(agv_num, tray_quadrant);
+  });
+}
+
+int AriacCompetition::FloorRobotTransferTrayPart(int tray_cell, int agv_num, int tray_quadrant) {
+  int part_type_clr = -1;
+  WorkspaceReservations::AreaMask areas = WorkspaceReservations::agv(tray_cell/10) | WorkspaceReservations::agv(agv_num) |
+                                          WorkspaceReservations::area(WorkspaceReservations::kTrayTables);
+  arms_.run(DualArmExecutor::Arm::kFloor, areas, [&] {
+    part_type_clr = PickKitTrayPart(tray_cell);
+    return FloorRobotPlacePartOnKitTray(agv_num, tray_quadrant);
+  });
+  return part_type_clr;
+}
+
+std::shared_future<bool> AriacCompetition::DispatchAgv(int agv_num, int destination, bool lock) {
+  // The kit tray leaves the kitting area with the AGV
+  kit_trays_.clear(agv_num);
+  state_journal_.kit_tray_cleared(agv_num);
+  return agvs_.move(agv_num, destination, [this, agv_num, destination, lock] {
+    if (lock) {
+      lock_agv(agv_num);
+    }
+    bool moved = move_agv(agv_num, destination);
+    if (lock) {
+      unlock_agv(agv_num);
+    }
+    return moved;
+  });
+}
+
 int AriacCompetition::search_bin(int part) {
-  for (auto& it : bin_map) {
-    if (it.second.part_type_clr == part) {
-      return it.first;
+  if (part == -1) {
+    return bin_map.find(part);
+  }
+  SlotMask reserved;
+  if (!order_tasks_.empty()) {
+    reserved = reservation_ledger_.blocked_for(order_tasks_.back().order().GetId());
+  }
+  return bin_map.nearest(part, FloorRobotTravelCost(), reserved);
+}
+
+SlotTravelCost AriacCompetition::FloorRobotTravelCost() {
+  SlotTravelCost cost;
+  cost.right_bins_rail = rail_positions_["right_bins"];
+  cost.left_bins_rail = rail_positions_["left_bins"];
+  cost.floor_reachable = FloorRobotReachableSlots();
+  moveit::core::RobotStatePtr state = floor_robot_->getCurrentState(0.1);
+  if (state) {
+    cost.rail_position = state->getVariablePosition("linear_actuator_joint");
+  }
+  return cost;
+}
+
+const PickPlan& AriacCompetition::PlanKitPicks(const std::string& order_id, const std::vector<int>& parts, size_t done, int agv_num) {
+  std::string agv = "agv" + std::to_string(agv_num);
+  PickTravelModel model;
+  model.right_bins_rail = rail_positions_["right_bins"];
+  model.left_bins_rail = rail_positions_["left_bins"];
+  model.agv_rail = rail_positions_[agv];
+  model.right_bins_gantry = gantry_positions_["right_bins"];
+  model.left_bins_gantry = gantry_positions_["left_bins"];
+  model.agv_gantry = gantry_positions_[agv];
+  model.floor_reachable = FloorRobotReachableSlots();
+  moveit::core::RobotStatePtr floor_state = floor_robot_->getCurrentState(0.1);
+  if (floor_state) {
+    model.rail_position = floor_state->getVariablePosition("linear_actuator_joint");
+  }
+  moveit::core::RobotStatePtr ceil_state = ceil_robot_->getCurrentState(0.1);
+  if (ceil_state) {
+    model.gantry_position = ceil_state->getVariablePosition("gantry_y_axis_joint");
+  }
+
+  const PickPlan& plan = pick_sequencer_.plan(order_id, parts, done, bin_map.snapshot(),
+                                              reservation_ledger_.blocked_for(order_id), model);
+  std::string steps;
+  for (size_t i = done; i < plan.steps.size(); i++) {
+    steps += " " + std::to_string(plan.steps[i].part) + "@" + std::to_string(plan.steps[i].quadrant);
+  }
+  RCLCPP_INFO_STREAM(this->get_logger(), "Pick sequence of order " << order_id << " (part@quadrant):" << steps
+                     << ", " << plan.seconds << " s of travel");
+  return plan;
+}
+
+std::vector<int> AriacCompetition::OrderPartKeys(const Orders& order) {
+  std::vector<int> keys;
+  if (order.GetType() == ariac_msgs::msg::Order::KITTING) {
+    for (const auto& part : order.GetKitting()->GetParts()) {
+      keys.push_back(part[1]*10 + part[0]);
+    }
+  } else if (order.GetType() == ariac_msgs::msg::Order::COMBINED) {
+    for (const auto& part : order.GetCombined()->GetParts()) {
+      keys.push_back(part.type*10 + part.color);
     }
   }
-  return -1;
+  // Assembly parts are already on the AGVs
+  return keys;
 }
 
-void AriacCompetition::setup_map() {
-  for(unsigned int i = 1; i <= 72; i++){
-    bin_map[i];
+void AriacCompetition::ReserveOrderParts(const std::string& order_id, bool priority, const std::vector<int>& bill) {
+  // The order thread may be refreshing the inventory, reserve against the last published snapshot
+  CellSnapshot snapshot = CurrentCellSnapshot();
+  std::vector<int> shortages = reservation_ledger_.reserve(order_id, priority, bill, snapshot.bins(),
+                                                           snapshot.conveyor(), snapshot.kit_trays().reusable_parts());
+  for (int part : shortages) {
+    RCLCPP_WARN_STREAM(this->get_logger(), "Order " << order_id << " is short of " << ConvertPartColorToString(part%10) << " " << ConvertPartTypeToString(part/10));
   }
 }
 
+void AriacCompetition::ConsumeBinPart(int quadrant) {
+  if (!order_tasks_.empty()) {
+    reservation_ledger_.consume(order_tasks_.back().order().GetId(), bin_map[quadrant].part_type_clr, ReservationLedger::Source::kBin, quadrant);
+  }
+  UpdateBinPart(quadrant, -1);
+}
+
+void AriacCompetition::UpdateBinPart(int quadrant, int part_type_clr) {
+  if (bin_map[quadrant].part_type_clr != part_type_clr) {
+    state_journal_.slot_changed(quadrant, part_type_clr);
+  }
+  if (part_type_clr == -1) {
+    bin_map.clear(quadrant);
+  } else {
+    bin_map.set(quadrant, part_type_clr, bin_quadrant_pose(quadrant));
+  }
+}
+
+void AriacCompetition::UpdateBinPart(int quadrant, int part_type_clr, const geometry_msgs::msg::Pose& pose) {
+  if (bin_map[quadrant].part_type_clr != part_type_clr) {
+    state_journal_.slot_changed(quadrant, part_type_clr);
+  }
+  bin_map.set(quadrant, part_type_clr, pose);
+}
+
+int AriacCompetition::CopyBinSlots(const group3::msg::BinSlots::ConstSharedPtr& slots) {
+  static_assert(sizeof(SlotPose) == 7 * sizeof(double), "BinSlots poses are 7 doubles per slot");
+  if (!slots) {
+    return 0;
+  }
+  int count = 0;
+  for (uint64_t bits = slots->occupied; bits != 0; bits &= bits - 1) {
+    int slot = __builtin_ctzll(bits);
+    if (slot >= group3::msg::BinSlots::SLOTS) {
+      break;
+    }
+    int quadrant = slots->first_quadrant + slot;
+    if ((slots->refined >> slot) & 1) {
+      SlotPose pose;
+      std::memcpy(&pose, &slots->pose[7 * slot], sizeof(SlotPose));
+      UpdateBinPart(quadrant, slots->part[slot], pose.to_msg());
+    } else {
+      UpdateBinPart(quadrant, slots->part[slot]);
+    }
+    count++;
+  }
+  // The detection covers every slot of the camera, a slot it saw empty no longer holds a part
+  for (int slot = 0; slot < group3::msg::BinSlots::SLOTS; slot++) {
+    if (!((slots->occupied >> slot) & 1)) {
+      UpdateBinPart(slots->first_quadrant + slot, -1);
+    }
+  }
+  return count;
+}
+
+void AriacCompetition::RecordKitTrayPart(int agv_num, int quadrant, int part_type_clr) {
+  std::string order_id = order_tasks_.empty() ? "" : order_tasks_.back().order().GetId();
+  kit_trays_.place(agv_num, quadrant, part_type_clr, traypartpose, order_id);
+  state_journal_.part_placed(agv_num, quadrant, part_type_clr, order_id, traypartpose);
+}
+
+int AriacCompetition::PickKitTrayPart(int tray_cell) {
+  int agv_num = tray_cell / 10;
+  int quadrant = tray_cell % 10;
+  KitTrayModel::TrayPart part = kit_trays_.at(agv_num, quadrant);
+  RCLCPP_INFO_STREAM(this->get_logger(), "Reusing " << ConvertPartColorToString(part.part_type_clr%10) << " " << ConvertPartTypeToString(part.part_type_clr/10)
+                     << " from quadrant " << quadrant << " of AGV " << agv_num << " (order " << part.order_id << ")");
+  FloorRobotPickTrayPart(part.part_type_clr%10, part.part_type_clr/10, part.pose, agv_num);
+  kit_trays_.remove(agv_num, quadrant);
+  state_journal_.part_removed(agv_num, quadrant);
+  if (!order_tasks_.empty()) {
+    reservation_ledger_.consume(order_tasks_.back().order().GetId(), part.part_type_clr, ReservationLedger::Source::kKitTray);
+  }
+  return part.part_type_clr;
+}
+
+void AriacCompetition::RecordKitTrayQuality(int agv_num, const std::vector<bool>& quality_check) {
+  // Quadrant q reports all_passed, missing, flipped and faulty at 3 + (q-1)*6 onwards
+  for (int quadrant = 1; quadrant <= KitTrayModel::kQuadrants && 6 + (quadrant - 1)*6 < static_cast<int>(quality_check.size()); quadrant++) {
+    if (kit_trays_.at(agv_num, quadrant).part_type_clr == -1) {
+      continue;
+    }
+    int base = 3 + (quadrant - 1)*6;
+    if (quality_check[base + 1]) {
+      kit_trays_.remove(agv_num, quadrant);
+      state_journal_.part_removed(agv_num, quadrant);
+    } else if (quality_check[base + 3]) {
+      kit_trays_.set_quality(agv_num, quadrant, KitTrayModel::Quality::kFaulty);
+    } else if (quality_check[base + 2]) {
+      kit_trays_.set_quality(agv_num, quadrant, KitTrayModel::Quality::kFlipped);
+    } else {
+      kit_trays_.set_quality(agv_num, quadrant, KitTrayModel::Quality::kPassed);
+    }
+  }
+}
+
+CellSnapshot AriacCompetition::CurrentCellSnapshot() {
+  std::lock_guard<std::mutex> lock(cell_snapshot_mutex_);
+  return cell_snapshot_;
+}
+
+CellSnapshot AriacCompetition::RefreshCellSnapshot() {
+  std::lock_guard<std::mutex> lock(cell_snapshot_mutex_);
+  CellSnapshot next = cell_snapshot_;
+  if (bin_map.revision() != cell_snapshot_bins_revision_) {
+    next = next.with_bins(bin_map.snapshot());
+    cell_snapshot_bins_revision_ = bin_map.revision();
+  }
+  std::vector<int> conveyor = ConveyorParts();
+  if (conveyor != next.conveyor()) {
+    next = next.with_conveyor(conveyor);
+  }
+  if (kit_trays_.revision() != cell_snapshot_kit_trays_revision_) {
+    next = next.with_kit_trays(kit_trays_);
+    cell_snapshot_kit_trays_revision_ = kit_trays_.revision();
+  }
+  GripperParts grippers;
+  if (floor_gripper_state_.attached) {
+    grippers.floor_part = floor_robot_attached_part_.type*10 + floor_robot_attached_part_.color;
+  }
+  // The ceiling robot's worker writes its part during an assembly, keep the last known part until it is idle.
+  // Only this thread queues ceiling actions, so an idle worker stays idle while the part is read.
+  grippers.ceiling_part = next.grippers().ceiling_part;
+  if (arms_.idle(DualArmExecutor::Arm::kCeiling)) {
+    grippers.ceiling_part = ceil_gripper_state_.attached ? ceil_robot_attached_part_.type*10 + ceil_robot_attached_part_.color : -1;
+  }
+  if (!(grippers == next.grippers())) {
+    next = next.with_grippers(grippers);
+  }
+
+  const char* areas[] = {"Bin quadrant", "Conveyor part", "Kit tray", "Gripper"};
+  for (const auto& change : diff(cell_snapshot_, next)) {
+    std::string before = change.before == -1 ? "empty" : ConvertPartColorToString(change.before%10) + " " + ConvertPartTypeToString(change.before/10);
+    std::string after = change.after == -1 ? "empty" : ConvertPartColorToString(change.after%10) + " " + ConvertPartTypeToString(change.after/10);
+    RCLCPP_INFO_STREAM(this->get_logger(), areas[static_cast<int>(change.area)] << " " << change.slot << ": " << before << " -> " << after);
+  }
+  cell_snapshot_ = next;
+  return next;
+}
+
+void AriacCompetition::RestoreJournalState() {
+  StateJournal::State state = state_journal_.state();
+  for (int quadrant = 1; quadrant <= static_cast<int>(state.slots.size()); quadrant++) {
+    if (state.slots[quadrant - 1] != -1) {
+      bin_map.set(quadrant, state.slots[quadrant - 1], bin_quadrant_pose(quadrant));
+    }
+  }
+  for (const auto& part : state.kit_tray_parts) {
+    kit_trays_.place(part.first.first, part.first.second, part.second.part_type_clr, part.second.pose, part.second.order_id);
+  }
+  for (const auto& agv : state.agv_destinations) {
+    available_agvs.erase(std::remove(available_agvs.begin(), available_agvs.end(), agv.first), available_agvs.end());
+    agvs_.set_location(agv.first, agv.second);
+  }
+  for (int quadrant : state.allocated_slots) {
+    bin_map.claim(quadrant);
+  }
+  {
+    std::lock_guard<std::mutex> lock(conveyor_mutex_);
+    if (state.conveyor_announced) {
+      conveyor_parts = state.conveyor_parts;
+      conveyor_size = state.conveyor_size;
+      conveyor_parts_flag_ = true;
+    } else if (conveyor_parts_flag_) {
+      state_journal_.conveyor_announced(conveyor_size, conveyor_parts);
+    }
+  }
+
+  // Orders accepted before the restart were announced before any new one, keep their order
+  rclcpp::Serialization<ariac_msgs::msg::Order> serialization;
+  int64_t announced = 0;
+  int requeued = 0;
+  for (const auto& order : state.orders) {
+    if (!order.complete()) {
+      RCLCPP_WARN_STREAM(this->get_logger(), "Order " << order.id << " was cut short in the state journal, not requeued");
+      continue;
+    }
+    rclcpp::SerializedMessage serialized(order.message.size());
+    rcl_serialized_message_t& raw = serialized.get_rcl_serialized_message();
+    std::memcpy(raw.buffer, order.message.data(), order.message.size());
+    raw.buffer_length = order.message.size();
+    ariac_msgs::msg::Order msg;
+    try {
+      serialization.deserialize_message(&serialized, &msg);
+    } catch (const std::exception& e) {
+      RCLCPP_WARN_STREAM(this->get_logger(), "Order " << order.id << " could not be read from the state journal: " << e.what());
+      continue;
+    }
+    if (QueueOrder(msg, announced++)) {
+      requeued++;
+    }
+  }
+  RCLCPP_INFO_STREAM(this->get_logger(), "Restored " << bin_map.occupied_count() << " bin parts, " << kit_trays_.size()
+                     << " kit tray parts, " << state.agv_destinations.size() << " moved AGVs, " << ConveyorParts().size()
+                     << " conveyor parts and " << requeued << " orders from " << state_journal_.size() << " journal records");
+}
+
+void AriacCompetition::CheckJournalCompetition(bool new_competition) {
+  if (journal_checked_ || !state_journal_.is_open()) {
+    return;
+  }
+  int64_t now = this->now().nanoseconds();
+  if (now == 0 && !new_competition) {
+    // No clock yet, checked on the next competition state
+    return;
+  }
+  journal_checked_ = true;
+
+  int64_t start = state_journal_.competition_start();
+  if (!new_competition && start > 0 && start <= now) {
+    RestoreJournalState();
+    return;
+  }
+  if (!new_competition) {
+    RCLCPP_WARN_STREAM(this->get_logger(), "State journal is from another competition, discarding it");
+  }
+  if (!state_journal_.start(std::max<int64_t>(now, 1))) {
+    RCLCPP_ERROR_STREAM(this->get_logger(), "Unable to reset the state journal");
+  }
+  // The conveyor may have been announced before the journal was matched
+  std::lock_guard<std::mutex> lock(conveyor_mutex_);
+  if (conveyor_parts_flag_) {
+    state_journal_.conveyor_announced(conveyor_size, conveyor_parts);
+  }
+}
+
+SlotMask AriacCompetition::FloorRobotReachableSlots() {
+  SlotMask slots;
+  for (int quadrant = 1; quadrant <= BinInventory::kQuadrants; quadrant++) {
+    if (FloorRobotReachableWorkspace(quadrant)) {
+      slots.set(quadrant - 1);
+    }
+  }
+  return slots;
+}
+
 std::string AriacCompetition::ConvertPartTypeToString(int part_type) {
   if (part_type == ariac_msgs::msg::Part::BATTERY)
     return std::string("Battery")+"\033[0m";
@@ -1193,7 +1473,7 @@ void AriacCompetition::lock_agv(int agv_num) {
   std::string srv_name = "/ariac/agv" + std::to_string(agv_num) + "_lock_tray";
 
     std::shared_ptr<rclcpp::Node> node =
-        rclcpp::Node::make_shared("lock_agv_client");
+        rclcpp::Node::make_shared("lock_agv" + std::to_string(agv_num) + "_client");
     
     rclcpp::Client<std_srvs::srv::Trigger>::SharedPtr client =
         node->create_client<std_srvs::srv::Trigger>(srv_name);
@@ -1226,7 +1506,7 @@ void AriacCompetition::unlock_agv(int agv_num) {
   std::string srv_name = "/ariac/agv" + std::to_string(agv_num) + "_unlock_tray";
 
     std::shared_ptr<rclcpp::Node> node =
-        rclcpp::Node::make_shared("unlock_agv_client");
+        rclcpp::Node::make_shared("unlock_agv" + std::to_string(agv_num) + "_client");
     
     rclcpp::Client<std_srvs::srv::Trigger>::SharedPtr client =
         node->create_client<std_srvs::srv::Trigger>(srv_name);
@@ -1252,12 +1532,12 @@ void AriacCompetition::unlock_agv(int agv_num) {
     }
 }
 
-void AriacCompetition::move_agv(int agv_num, int dest) {
+bool AriacCompetition::move_agv(int agv_num, int dest) {
   // AriacCompetition::lock_agv(agv_num);
   std::string srv_name = "/ariac/move_agv" + std::to_string(agv_num);
 
     std::shared_ptr<rclcpp::Node> node =
-        rclcpp::Node::make_shared("move_agv_client");
+        rclcpp::Node::make_shared("move_agv" + std::to_string(agv_num) + "_client");
     
     rclcpp::Client<ariac_msgs::srv::MoveAGV>::SharedPtr client =
         node->create_client<ariac_msgs::srv::MoveAGV>(srv_name);
@@ -1279,9 +1559,16 @@ void AriacCompetition::move_agv(int agv_num, int dest) {
 
     if (rclcpp::spin_until_future_complete(node, result) ==
         rclcpp::FutureReturnCode::SUCCESS) {
+      if (!result.get()->success) {
+        RCLCPP_ERROR_STREAM(this->get_logger(), "AGV " << agv_num << " did not move to " << ConvertDestinationToString(agv_num,dest) << ": " << result.get()->message);
+        return false;
+      }
       RCLCPP_INFO_STREAM(this->get_logger(),"Moved AGV " << agv_num << " to " << ConvertDestinationToString(agv_num,dest));
+      state_journal_.agv_moved(agv_num, dest);
+      return true;
     } else {
       RCLCPP_ERROR_STREAM(this->get_logger(), "Failed to call trigger service");
+      return false;
     }
 }
 
@@ -1321,6 +1608,7 @@ void AriacCompetition::conv_camera_cb(const ariac_msgs::msg::BasicLogicalCameraI
         conv_camera_received_data = true;
     }
 
+    std::lock_guard<std::mutex> lock(conveyor_mutex_);
     conv_parts_ = msg->part_poses;
     conv_camera_pose_ = msg->sensor_pose;
 }
@@ -1331,7 +1619,7 @@ void AriacCompetition::kts1_rgb_camera_cb(const sensor_msgs::msg::Image::ConstSh
         RCLCPP_INFO(get_logger(), "Received data from kts1 camera");
         kts1_rgb_camera_received_data = true;
     }
-    kts1_rgb_camera_image_ = cv_bridge::toCvShare(msg, "bgr8")->image;
+    kts1_rgb_camera_frame_.push(msg);
 }
 
 void AriacCompetition::kts2_rgb_camera_cb(const sensor_msgs::msg::Image::ConstSharedPtr msg){
@@ -1340,7 +1628,7 @@ void AriacCompetition::kts2_rgb_camera_cb(const sensor_msgs::msg::Image::ConstSh
         RCLCPP_INFO(get_logger(), "Received data from kts2 camera");
         kts2_rgb_camera_received_data = true;
     }
-    kts2_rgb_camera_image_ = cv_bridge::toCvShare(msg, "bgr8")->image;
+    kts2_rgb_camera_frame_.push(msg);
 }
 
 void AriacCompetition::left_bins_rgb_camera_cb(const sensor_msgs::msg::Image::ConstSharedPtr msg){
@@ -1349,7 +1637,7 @@ void AriacCompetition::left_bins_rgb_camera_cb(const sensor_msgs::msg::Image::Co
         RCLCPP_INFO(get_logger(), "Received data from left bins camera");
         left_bins_rgb_camera_received_data = true;
     }
-    left_bins_rgb_camera_image_ = cv_bridge::toCvShare(msg, "bgr8")->image;
+    left_bins_rgb_camera_frame_.push(msg);
 }
 
 void AriacCompetition::right_bins_rgb_camera_cb(const sensor_msgs::msg::Image::ConstSharedPtr msg){
@@ -1358,25 +1646,33 @@ void AriacCompetition::right_bins_rgb_camera_cb(const sensor_msgs::msg::Image::C
         RCLCPP_INFO(get_logger(), "Received data from right bins camera");
         right_bins_rgb_camera_received_data = true;
     }
-    right_bins_rgb_camera_image_ = cv_bridge::toCvShare(msg, "bgr8")->image;
+    right_bins_rgb_camera_frame_.push(msg);
 }
 
-void AriacCompetition::right_part_detector_cb(const group3::msg::Parts::ConstSharedPtr msg){
+void AriacCompetition::right_part_detector_cb(const group3::msg::BinSlots::ConstSharedPtr msg){
     if (!right_part_detector_received_data)
     {
         RCLCPP_INFO(get_logger(), "Received data from Right part detector node");
         right_part_detector_received_data = true;
     }
-    right_parts_ = msg->parts;
+    {
+        std::lock_guard<std::mutex> lock(bin_parts_mutex_);
+        right_slots_ = msg;
+    }
+    inventory_readiness_.notify(InventoryReadiness::kRightBins, rclcpp::Time(msg->header.stamp).nanoseconds());
 }
 
-void AriacCompetition::left_part_detector_cb(const group3::msg::Parts::ConstSharedPtr msg){
+void AriacCompetition::left_part_detector_cb(const group3::msg::BinSlots::ConstSharedPtr msg){
     if (!left_part_detector_received_data)
     {
         RCLCPP_INFO(get_logger(), "Received data from Left part detector node");
         left_part_detector_received_data = true;
     }
-    left_parts_ = msg->parts;
+    {
+        std::lock_guard<std::mutex> lock(bin_parts_mutex_);
+        left_slots_ = msg;
+    }
+    inventory_readiness_.notify(InventoryReadiness::kLeftBins, rclcpp::Time(msg->header.stamp).nanoseconds());
 }
 
 void AriacCompetition::conv_part_detector_cb(
@@ -1387,6 +1683,7 @@ void AriacCompetition::conv_part_detector_cb(
         conv_part_detector_received_data = true;
     }
 
+    std::lock_guard<std::mutex> lock(conveyor_mutex_);
     conv_rgb_parts_ = *msg;
 }
 
@@ -1397,16 +1694,23 @@ void AriacCompetition::breakbeam_cb(const ariac_msgs::msg::BreakBeamStatus::Cons
         breakbeam_received_data = true;
     }
     breakbeam_time_sec = msg->header.stamp.sec;
-    breakbeam_status = msg->object_detected;
+    {
+      std::lock_guard<std::mutex> lock(conveyor_mutex_);
+      breakbeam_status = msg->object_detected;
 
-    if (breakbeam_trigger == false && breakbeam_status == true){
-      conveyor_parts.pop_back();
-      breakbeam_trigger = true;
-    }
+      if (breakbeam_trigger == false && breakbeam_status == true){
+        if (!conveyor_parts.empty()) {
+          conveyor_parts.pop_back();
+        }
+        state_journal_.conveyor_part_passed(static_cast<int>(conveyor_parts.size()));
+        breakbeam_trigger = true;
+      }
 
-    if (breakbeam_trigger == true && breakbeam_status == false){
-      breakbeam_trigger = false;
+      if (breakbeam_trigger == true && breakbeam_status == false){
+        breakbeam_trigger = false;
+      }
     }
+    conveyor_cv_.notify_all();
 }
 
 void AriacCompetition::breakbeam1_cb(const ariac_msgs::msg::BreakBeamStatus::ConstSharedPtr msg){
@@ -1424,7 +1728,11 @@ void AriacCompetition::breakbeam2_cb(const ariac_msgs::msg::BreakBeamStatus::Con
         RCLCPP_INFO(get_logger(), "Received data from breakbeam2 node");
         breakbeam2_received_data = true;
     }
-    breakbeam2_status = msg->object_detected;
+    {
+      std::lock_guard<std::mutex> lock(conveyor_mutex_);
+      breakbeam2_status = msg->object_detected;
+    }
+    conveyor_cv_.notify_all();
 }
 
 void AriacCompetition::as1_state_cb(
@@ -1545,6 +1853,10 @@ geometry_msgs::msg::Quaternion AriacCompetition::QuaternionFromRPY(double r, dou
     return q_msg;
 }
 
+std::string AriacCompetition::PlanningScenePartName(const std::string& robot, int part_clr, int part_type) {
+  return robot + "_" + part_colors_[part_clr] + "_" + part_types_[part_type];
+}
+
 void AriacCompetition::AddModelToPlanningScene(std::string name, std::string mesh_file, geometry_msgs::msg::Pose model_pose)
 {
     moveit_msgs::msg::CollisionObject collision;
@@ -1866,7 +2178,6 @@ void AriacCompetition::FloorRobotChangeGripper(std::string gripper_type, std::st
 }
 
 void AriacCompetition::FloorRobotPickandPlaceTray(int tray_idx , int agv_num){
-  tray_poses = define_tray_poses();
   std::vector<int> kts1_vec;
   std::vector<int> kts2_vec;
   geometry_msgs::msg::Pose tray_camera_pose;
@@ -1880,14 +2191,16 @@ void AriacCompetition::FloorRobotPickandPlaceTray(int tray_idx , int agv_num){
     dont_change_gripper = true;
   }
 
-  kts1_vec = tray_detect(kts1_rgb_camera_image_);
-  kts2_vec = tray_detect(kts2_rgb_camera_image_);
+  CameraFrame kts1_frame = kts1_rgb_camera_frame_.latest();
+  CameraFrame kts2_frame = kts2_rgb_camera_frame_.latest();
+  kts1_vec = kts1_tray_detector_.detect(kts1_frame.bgr, kts1_frame.stamp);
+  kts2_vec = kts2_tray_detector_.detect(kts2_frame.bgr, kts2_frame.stamp);
 
   if (std::find(kts1_vec.begin(), kts1_vec.end(), tray_idx) != kts1_vec.end()) {
       auto tray_it = std::find(kts1_vec.begin(), kts1_vec.end(), tray_idx);
       tray_id = tray_it - kts1_vec.begin();
       station = "kts1";
-      tray_pose = tray_poses[tray_id];
+      tray_pose = ::tray_pose(tray_id);
       if (floor_gripper_state_.type != "tray_gripper") {
         FloorRobotChangeGripper("trays","kts1");
       }
@@ -1895,7 +2208,7 @@ void AriacCompetition::FloorRobotPickandPlaceTray(int tray_idx , int agv_num){
       auto tray_it = std::find(kts2_vec.begin(), kts2_vec.end(), tray_idx);
       tray_id = tray_it - kts2_vec.begin();
       station = "kts2";
-      tray_pose = tray_poses[tray_id+3];
+      tray_pose = ::tray_pose(tray_id+3);
       if (floor_gripper_state_.type != "tray_gripper")
       {
         FloorRobotChangeGripper("trays","kts2");
@@ -2017,7 +2330,7 @@ bool AriacCompetition::FloorRobotPickBinPart(int part_clr,int part_type,geometry
   }
 
   // Add part to planning scene
-  std::string part_name = part_colors_[part_clr] + "_" + part_types_[part_type];
+  std::string part_name = PlanningScenePartName("floor", part_clr, part_type);
   AddModelToPlanningScene(part_name, part_types_[part_type] + ".stl", part_pose);
   floor_robot_->attachObject(part_name);
   ariac_msgs::msg::Part part_to_pick;
@@ -2085,9 +2398,9 @@ bool AriacCompetition::FloorRobotPlacePartOnKitTray(int agv_num, int quadrant) {
 
   FloorRobotMoveCartesian(waypoints, 0.1, 0.1);
 
-  auto QualityCheck = CheckFaultyPart(current_order[0].GetId());
+  auto QualityCheck = CheckFaultyPart(order_tasks_.back().order().GetId());
   usleep(4000);
-  QualityCheck = CheckFaultyPart(current_order[0].GetId());
+  QualityCheck = CheckFaultyPart(order_tasks_.back().order().GetId());
 
   if(QualityCheck[6] || QualityCheck[12] || QualityCheck[18] || QualityCheck[24]){
     floor_robot_->setJointValueTarget("linear_actuator_joint", rail_positions_["agv" + std::to_string(agv_num)]);
@@ -2096,8 +2409,7 @@ bool AriacCompetition::FloorRobotPlacePartOnKitTray(int agv_num, int quadrant) {
     floor_robot_->setJointValueTarget(floor_disposal_poses_[agv_num]);
     FloorRobotMovetoTarget();
     FloorRobotSetGripperState(false);
-    std::string part_name = part_colors_[floor_robot_attached_part_.color] +
-                            "_" + part_types_[floor_robot_attached_part_.type];
+    std::string part_name = PlanningScenePartName("floor", floor_robot_attached_part_.color, floor_robot_attached_part_.type);
     floor_robot_->detachObject(part_name);
 
     planning_scene_.removeCollisionObjects({part_name});
@@ -2107,6 +2419,7 @@ bool AriacCompetition::FloorRobotPlacePartOnKitTray(int agv_num, int quadrant) {
     floor_robot_->setJointValueTarget("floor_shoulder_pan_joint", 0);
     FloorRobotMovetoTarget();
     traypartpose = BuildPose(-1000,0,0,SetRobotOrientation(0));
+    return false;
   } else {
 
     // Check if flipped
@@ -2115,8 +2428,7 @@ bool AriacCompetition::FloorRobotPlacePartOnKitTray(int agv_num, int quadrant) {
     } else {
 
       FloorRobotSetGripperState(false);
-      std::string part_name = part_colors_[floor_robot_attached_part_.color] +
-                              "_" + part_types_[floor_robot_attached_part_.type];
+      std::string part_name = PlanningScenePartName("floor", floor_robot_attached_part_.color, floor_robot_attached_part_.type);
       floor_robot_->detachObject(part_name);
       planning_scene_.removeCollisionObjects({part_name});
 
@@ -2128,6 +2440,7 @@ bool AriacCompetition::FloorRobotPlacePartOnKitTray(int agv_num, int quadrant) {
       FloorRobotMoveCartesian(waypoints, 0.4, 0.1);
     }
   }
+  return true;
 }
 
 bool AriacCompetition::FloorRobotPickTrayPart(int part_clr, int part_type, geometry_msgs::msg::Pose part_pose, int agv_num) {
@@ -2151,7 +2464,7 @@ bool AriacCompetition::FloorRobotPickTrayPart(int part_clr, int part_type, geome
   FloorRobotWaitForAttach(100.0);
 
   // Add part to planning scene
-  std::string part_name = part_colors_[part_clr] + "_" + part_types_[part_type];
+  std::string part_name = PlanningScenePartName("floor", part_clr, part_type);
   AddModelToPlanningScene(part_name, part_types_[part_type] + ".stl", part_pose);
   floor_robot_->attachObject(part_name);
   ariac_msgs::msg::Part part_to_pick;
@@ -2171,17 +2484,12 @@ bool AriacCompetition::FloorRobotPickTrayPart(int part_clr, int part_type, geome
 }
 
 bool AriacCompetition::FloorRobotPickConvPart(std::vector<geometry_msgs::msg::Pose> part_pose,group3::msg::Part conv_part){
-  int q = search_bin(-1);
-  while (!FloorRobotReachableWorkspace(q)){
-    q+=1;
-    while (std::find(occupied_quadrants.begin(), occupied_quadrants.end(), q) != occupied_quadrants.end()){
-      q+=1;
-    }
-  }
-  while (std::find(occupied_quadrants.begin(), occupied_quadrants.end(), q) != occupied_quadrants.end()){
-      q+=1;
+  int q = bin_map.allocate(FloorRobotTravelCost());
+  if (q == -1) {
+    RCLCPP_WARN_STREAM(this->get_logger(), "No free bin quadrant to place the conveyor part");
+    return false;
   }
-  occupied_quadrants.push_back(q);
+  state_journal_.slot_allocated(q);
 
   std::string bin_side;
   if (q < 37) {
@@ -2199,7 +2507,11 @@ bool AriacCompetition::FloorRobotPickConvPart(std::vector<geometry_msgs::msg::Po
   }
   int part_clr = conv_part.color;
   int part_type = conv_part.type;
-  geometry_msgs::msg::Pose camera_pose_ = conv_camera_pose_;
+  geometry_msgs::msg::Pose camera_pose_;
+  {
+    std::lock_guard<std::mutex> lock(conveyor_mutex_);
+    camera_pose_ = conv_camera_pose_;
+  }
   geometry_msgs::msg::Pose part_camera_pose = part_pose[0];
 
   geometry_msgs::msg::Pose part_pose_;
@@ -2275,7 +2587,7 @@ bool AriacCompetition::FloorRobotPickConvPart(std::vector<geometry_msgs::msg::Po
 
   waypoints.clear();
   geometry_msgs::msg::Pose current_pose = floor_robot_->getCurrentPose().pose;
-  std::string part_name = part_colors_[part_clr] + "_" + part_types_[part_type];
+  std::string part_name = PlanningScenePartName("floor", part_clr, part_type);
   AddModelToPlanningScene(part_name, part_types_[part_type] + ".stl", current_pose);
   floor_robot_->attachObject(part_name);
 
@@ -2291,7 +2603,7 @@ bool AriacCompetition::FloorRobotPickConvPart(std::vector<geometry_msgs::msg::Po
   waypoints.clear();
 
   
-  geometry_msgs::msg::Pose set_pose = bin_quadrant_poses[q];
+  geometry_msgs::msg::Pose set_pose = bin_quadrant_pose(q);
 
   if (part_type == ariac_msgs::msg::Part::PUMP){
     tf2::Quaternion tf_q;
@@ -2321,6 +2633,8 @@ bool AriacCompetition::FloorRobotPickConvPart(std::vector<geometry_msgs::msg::Po
   FloorRobotSetGripperState(false);
   floor_robot_->detachObject(part_name);
   planning_scene_.removeCollisionObjects({part_name});
+  // The order that counted on this conveyor part now holds its bin quadrant
+  reservation_ledger_.conveyor_part_placed(part_type*10 + part_clr, q);
 
   waypoints.clear();
   waypoints.push_back(BuildPose(set_pose.position.x, set_pose.position.y,
@@ -2328,11 +2642,7 @@ bool AriacCompetition::FloorRobotPickConvPart(std::vector<geometry_msgs::msg::Po
   FloorRobotMoveCartesian(waypoints, 1, 1);
   
   FloorRobotMoveConveyorHome();
-
-  if (conveyor_parts.size()==0){
-    return true;
-  }
-
+  return true;
 }
 
 std::vector<bool> AriacCompetition::CheckFaultyPart(std::string order_id){
@@ -2395,8 +2705,8 @@ std::vector<bool> AriacCompetition::CheckFaultyPart(std::string order_id){
 void AriacCompetition::FlipPart(int part_clr, int part_type, int agv_num, int part_quad) {
   std::vector<geometry_msgs::msg::Pose> waypoints;
 
-  std::string part_name = part_colors_[part_clr] +
-                            "_" + part_types_[part_type];
+  std::string part_name = PlanningScenePartName("floor", part_clr, part_type);
+  std::string ceil_part_name = PlanningScenePartName("ceiling", part_clr, part_type);
   
   RCLCPP_INFO_STREAM(rclcpp::get_logger("Flip_Part"), "Move Robots to Flip Part pose");
   floor_robot_->setJointValueTarget(floor_flip_part_js_);
@@ -2428,10 +2738,10 @@ void AriacCompetition::FlipPart(int part_clr, int part_type, int agv_num, int pa
   waypoints.push_back(ceil_pose);
   CeilRobotMoveCartesian(waypoints, 0.05, 0.05,true);
 
-  AddModelToPlanningScene(part_name, part_types_[part_type] + ".stl", ceil_pose);
+  AddModelToPlanningScene(ceil_part_name, part_types_[part_type] + ".stl", ceil_pose);
   CeilRobotSetGripperState(true);
   FloorRobotSetGripperState(false);
-  ceil_robot_->attachObject(part_name);
+  ceil_robot_->attachObject(ceil_part_name);
 
   ariac_msgs::msg::Part part;
   part.color = part_clr;
@@ -2473,8 +2783,8 @@ void AriacCompetition::FlipPart(int part_clr, int part_type, int agv_num, int pa
   CeilRobotMoveCartesian(waypoints, 0.1, 0.1,true);
 
   CeilRobotSetGripperState(false);
-  ceil_robot_->detachObject(part_name);
-  planning_scene_.removeCollisionObjects({part_name});
+  ceil_robot_->detachObject(ceil_part_name);
+  planning_scene_.removeCollisionObjects({ceil_part_name});
   waypoints.clear();
   waypoints.push_back(BuildPose(part_drop_pose.position.x, part_drop_pose.position.y,
                                 part_drop_pose.position.z + 0.2,
@@ -2695,7 +3005,7 @@ bool AriacCompetition::CeilRobotPickBinPart(int part_clr,int part_type,geometry_
   }
 
   // Add part to planning scene
-  std::string part_name = part_colors_[part_clr] + "_" + part_types_[part_type];
+  std::string part_name = PlanningScenePartName("ceiling", part_clr, part_type);
   AddModelToPlanningScene(part_name, part_types_[part_type] + ".stl", part_pose);
   ceil_robot_->attachObject(part_name);
   ariac_msgs::msg::Part part_to_pick;
@@ -2748,26 +3058,25 @@ bool AriacCompetition::CeilRobotPlacePartOnKitTray(int agv_num, int quadrant) {
 
   CeilRobotMoveCartesian(waypoints, 0.1, 0.1,true);
 
-  auto QualityCheck = CheckFaultyPart(current_order[0].GetId());
+  auto QualityCheck = CheckFaultyPart(order_tasks_.back().order().GetId());
   usleep(2500);
-  QualityCheck = CheckFaultyPart(current_order[0].GetId());
+  QualityCheck = CheckFaultyPart(order_tasks_.back().order().GetId());
 
   if(QualityCheck[6] || QualityCheck[12] || QualityCheck[18] || QualityCheck[24]){
     ceil_robot_->setJointValueTarget(ceil_disposal_poses_[agv_num]);
     CeilRobotMovetoTarget();
     CeilRobotSetGripperState(false);
-    std::string part_name = part_colors_[ceil_robot_attached_part_.color] +
-                            "_" + part_types_[ceil_robot_attached_part_.type];
+    std::string part_name = PlanningScenePartName("ceiling", ceil_robot_attached_part_.color, ceil_robot_attached_part_.type);
     ceil_robot_->detachObject(part_name);
 
     planning_scene_.removeCollisionObjects({part_name});
     dropped_parts_.push_back(ceil_robot_attached_part_);
 
     CeilRobotMoveHome();
+    return false;
   } else{
     CeilRobotSetGripperState(false);
-    std::string part_name = part_colors_[ceil_robot_attached_part_.color] +
-                            "_" + part_types_[ceil_robot_attached_part_.type];
+    std::string part_name = PlanningScenePartName("ceiling", ceil_robot_attached_part_.color, ceil_robot_attached_part_.type);
     ceil_robot_->detachObject(part_name);
 
     waypoints.clear();
@@ -2781,7 +3090,7 @@ bool AriacCompetition::CeilRobotPlacePartOnKitTray(int agv_num, int quadrant) {
   if(QualityCheck[5] || QualityCheck[11] || QualityCheck[17] || QualityCheck[23]){
     //flip
   }
-
+  return true;
 }
 
 bool AriacCompetition::CeilRobotWaitForAssemble(int station, Part part)
@@ -2886,7 +3195,7 @@ bool AriacCompetition::CeilRobotPickAGVPart(ariac_msgs::msg::PartPose part)
   CeilRobotWaitForAttach(3.0);
 
   // Add part to planning scene
-  std::string part_name = part_colors_[part.part.color] + "_" + part_types_[part.part.type];
+  std::string part_name = PlanningScenePartName("ceiling", part.part.color, part.part.type);
   AddModelToPlanningScene(part_name, part_types_[part.part.type] + ".stl", part.pose);
   ceil_robot_->attachObject(part_name);
   ceil_robot_attached_part_ = part.part;
@@ -2971,8 +3280,7 @@ bool AriacCompetition::CeilRobotAssemblePart(int station, Part part)
 
   CeilRobotSetGripperState(false);
 
-  std::string part_name = part_colors_[ceil_robot_attached_part_.color] + 
-    "_" + part_types_[ceil_robot_attached_part_.type];
+  std::string part_name = PlanningScenePartName("ceiling", ceil_robot_attached_part_.color, ceil_robot_attached_part_.type);
   ceil_robot_->detachObject(part_name);
 
   // Move away slightly
@@ -2999,10 +3307,16 @@ int main(int argc, char *argv[])
 
     rclcpp::NodeOptions options;
     options.automatically_declare_parameters_from_overrides(true);
-    auto ariac_competition = std::make_shared<AriacCompetition>("group3_Competitor");
+
+    // Part detector shares the process so detections reach the competitor without a copy
+    rclcpp::NodeOptions intra_process_options;
+    intra_process_options.use_intra_process_comms(true);
+    auto ariac_competition = std::make_shared<AriacCompetition>("group3_Competitor", intra_process_options);
+    auto part_detector = std::make_shared<PartDetector>(intra_process_options);
     rclcpp::executors::MultiThreadedExecutor executor;
 
     executor.add_node(ariac_competition);
+    executor.add_node(part_detector);
 
     executor.spin();
     rclcpp::shutdown();
@@ -0,0 +1,279 @@
+/**
+ * @copyright Copyright (c) 2023
+ * @file bin_grid_detector.cpp
+ * @author Sanchit Kedia (sanchit@terpmail.umd.edu)
+ * @author Adarsh Malapaka (amalapak@terpmail.umd.edu)
+ * @author Tanmay Haldankar (tanmayh@terpmail.umd.edu)
+ * @author Sahruday Patti (sahruday@umd.edu)
+ * @author Kshitij Karnawat (kshitij@umd.edu)
+ * @brief Implementation of the table driven bin part detector for ARIAC 2023 (Group 3)
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ *
+ */
+#include "bin_grid_detector.hpp"
+#include "part_type_detect.hpp"
+#include "color_segmentation.hpp"
+
+#include <algorithm>
+
+namespace {
+
+// Bin regions in the 640x480 right bins camera image
+const cv::Rect kRightBinTopRight(360, 28, 190, 195);
+const cv::Rect kRightBinTopLeft(118, 28, 191, 195);
+const cv::Rect kRightBinBottomRight(360, 267, 190, 191);
+const cv::Rect kRightBinBottomLeft(118, 267, 191, 191);
+
+// Bin regions in the 640x480 left bins camera image
+const cv::Rect kLeftBinTopRight(332, 28, 190, 192);
+const cv::Rect kLeftBinTopLeft(90, 28, 193, 192);
+const cv::Rect kLeftBinBottomRight(332, 267, 190, 191);
+const cv::Rect kLeftBinBottomLeft(90, 267, 193, 191);
+
+// Inclusive pixel ranges of the slot columns and rows inside a bin region
+const int kSlotCols[3][2] = {{0, 70}, {71, 135}, {137, 195}};
+const int kSlotRows[3][2] = {{0, 65}, {69, 126}, {130, 192}};
+
+// Mean absolute difference per channel above which a slot cell is considered changed
+constexpr double kSlotChangeThreshold = 2.0;
+
+// Border added around the changed cells so parts overlapping the slot gaps are segmented whole
+constexpr int kCellMargin = 8;
+
+}  // namespace
+
+std::vector<BinLayout> right_bins_layout(int camera) {
+    return {{camera, kRightBinBottomRight, 1},
+            {camera, kRightBinBottomLeft, 10},
+            {camera, kRightBinTopLeft, 19},
+            {camera, kRightBinTopRight, 28}};
+}
+
+std::vector<BinLayout> left_bins_layout(int camera) {
+    return {{camera, kLeftBinBottomLeft, 37},
+            {camera, kLeftBinBottomRight, 46},
+            {camera, kLeftBinTopRight, 55},
+            {camera, kLeftBinTopLeft, 64}};
+}
+
+BinGridDetector::BinGridDetector(std::vector<BinLayout> layout, bool parallel, bool incremental)
+    : layout_(std::move(layout)),
+      buffers_(layout_.size()),
+      element_(cv::Mat::ones(3, 3, CV_8U)),
+      parallel_(parallel),
+      incremental_(incremental) {
+    for (size_t bin = 0; bin < layout_.size(); bin++) {
+        const cv::Size size = layout_[bin].roi.size();
+        BinBuffers& buf = buffers_[bin];
+
+        buf.slot_map = cv::Mat::zeros(size, CV_8U);
+        for (int row = 0; row < 3; row++) {
+            for (int col = 0; col < 3; col++) {
+                cv::Rect cell(kSlotCols[col][0], kSlotRows[row][0],
+                              kSlotCols[col][1] - kSlotCols[col][0] + 1,
+                              kSlotRows[row][1] - kSlotRows[row][0] + 1);
+                buf.cells[3 * row + col] = cell & cv::Rect(cv::Point(0, 0), size);
+                buf.slot_map(buf.cells[3 * row + col]) = 3 * row + col + 1;
+            }
+        }
+
+        buf.mask.create(size, CV_8U);
+        buf.morph.create(size, CV_8U);
+        buf.labels.create(size, CV_8U);
+        buf.blur.create(size, CV_8U);
+        buf.previous.create(size, CV_8UC3);
+        buf.part.fill(uint8_t{BinSlotDetections::kEmpty});
+        buf.confidence.fill(0);
+    }
+}
+
+void BinGridDetector::reset() {
+    for (auto& buf : buffers_) {
+        buf.has_previous = false;
+        buf.part.fill(uint8_t{BinSlotDetections::kEmpty});
+        buf.confidence.fill(0);
+    }
+}
+
+int BinGridDetector::slot_at(size_t bin, cv::Point p) const {
+    const cv::Mat& slot_map = buffers_[bin].slot_map;
+    if (p.x < 0 || p.y < 0 || p.x >= slot_map.cols || p.y >= slot_map.rows) {
+        return -1;
+    }
+    int slot = slot_map.at<uchar>(p);
+    return slot == 0 ? -1 : layout_[bin].first_slot + slot - 1;
+}
+
+void BinGridDetector::detect_bins(const std::vector<cv::Mat>& frames) {
+    auto process = [&](const cv::Range& range) {
+        for (int bin = range.start; bin < range.end; bin++) {
+            int camera = layout_[bin].camera;
+            if (camera < static_cast<int>(frames.size()) && !frames[camera].empty()) {
+                detect_bin(bin, frames[camera]);
+            } else {
+                buffers_[bin].has_previous = false;
+                buffers_[bin].part.fill(uint8_t{BinSlotDetections::kEmpty});
+                buffers_[bin].confidence.fill(0);
+            }
+        }
+    };
+
+    cv::Range bins(0, static_cast<int>(layout_.size()));
+    if (parallel_) {
+        cv::parallel_for_(bins, process);
+    } else {
+        process(bins);
+    }
+}
+
+std::vector<std::vector<int>> BinGridDetector::detect(const std::vector<cv::Mat>& frames) {
+    detect_bins(frames);
+
+    // Merge in table order, then by quadrant, so the output does not depend on scheduling
+    std::vector<std::vector<int>> parts;
+    for (size_t bin = 0; bin < layout_.size(); bin++) {
+        const BinBuffers& buf = buffers_[bin];
+        for (int slot = 0; slot < 9; slot++) {
+            if (buf.part[slot] != BinSlotDetections::kEmpty) {
+                parts.push_back({buf.part[slot] % 10, buf.part[slot] / 10, layout_[bin].first_slot + slot});
+            }
+        }
+    }
+    std::stable_sort(parts.begin(), parts.end(),
+                     [](const std::vector<int>& a, const std::vector<int>& b) { return a[2] < b[2]; });
+    return parts;
+}
+
+void BinGridDetector::detect(const std::vector<cv::Mat>& frames, BinSlotDetections& slots) {
+    detect_bins(frames);
+
+    slots.first_quadrant = layout_.empty() ? 1 : layout_[0].first_slot;
+    for (const auto& bin : layout_) {
+        slots.first_quadrant = std::min(slots.first_quadrant, bin.first_slot);
+    }
+    slots.occupied = 0;
+    slots.part.fill(uint8_t{BinSlotDetections::kEmpty});
+    slots.confidence.fill(0);
+    for (size_t bin = 0; bin < layout_.size(); bin++) {
+        const BinBuffers& buf = buffers_[bin];
+        for (int slot = 0; slot < 9; slot++) {
+            int index = layout_[bin].first_slot + slot - slots.first_quadrant;
+            if (index >= BinSlotDetections::kMaxSlots) {
+                break;
+            }
+            slots.part[index] = buf.part[slot];
+            slots.confidence[index] = buf.confidence[slot];
+            if (buf.part[slot] != BinSlotDetections::kEmpty) {
+                slots.occupied |= uint64_t{1} << index;
+            }
+        }
+    }
+}
+
+uint8_t BinGridDetector::color_confidence(const BinBuffers& buf, const cv::Rect& box, int color) {
+    int foreground = 0;
+    int matching = 0;
+    for (int y = box.y; y < box.y + box.height; y++) {
+        const uchar* mask = buf.mask.ptr<uchar>(y);
+        const uchar* labels = buf.labels.ptr<uchar>(y);
+        for (int x = box.x; x < box.x + box.width; x++) {
+            if (mask[x]) {
+                foreground++;
+                matching += label_color(labels[x]) == color ? 1 : 0;
+            }
+        }
+    }
+    return foreground == 0 ? 0 : static_cast<uint8_t>(255 * matching / foreground);
+}
+
+void BinGridDetector::detect_bin(size_t bin, const cv::Mat& frame) {
+    BinBuffers& buf = buffers_[bin];
+    cv::Mat img = frame(layout_[bin].roi);
+
+    // Slots whose pixels changed since the last processed frame, all of them without history
+    bool changed[9];
+    bool any_changed = false;
+    cv::Rect region;
+    for (int slot = 0; slot < 9; slot++) {
+        const cv::Rect& cell = buf.cells[slot];
+        changed[slot] = !incremental_ || !buf.has_previous ||
+                        cv::norm(img(cell), buf.previous(cell), cv::NORM_L1) >
+                            kSlotChangeThreshold * 3 * cell.area();
+        if (changed[slot]) {
+            cv::Rect grown(cell.x - kCellMargin, cell.y - kCellMargin,
+                           cell.width + 2 * kCellMargin, cell.height + 2 * kCellMargin);
+            region = any_changed ? (region | grown) : grown;
+            any_changed = true;
+        }
+    }
+    if (!any_changed) {
+        return;
+    }
+    region &= cv::Rect(cv::Point(0, 0), img.size());
+
+    // Keep the cached parts of unchanged slots
+    for (int slot = 0; slot < 9; slot++) {
+        if (changed[slot]) {
+            buf.part[slot] = BinSlotDetections::kEmpty;
+            buf.confidence[slot] = 0;
+        }
+    }
+
+    // Process only the changed region, the buffers are views so the filters must not read past it
+    cv::Mat mask = buf.mask(region);
+    cv::Mat morph = buf.morph(region);
+    cv::Mat labels = buf.labels(region);
+    cv::Mat blur = buf.blur(region);
+    const int border = cv::BORDER_CONSTANT | cv::BORDER_ISOLATED;
+
+    segment_colors(img(region), mask, labels);
+
+    // Opening (2 iterations) followed by closing, as in the original erode/dilate chain
+    cv::morphologyEx(mask, morph, cv::MORPH_OPEN, element_, cv::Point(-1, -1), 2,
+                     border, cv::morphologyDefaultBorderValue());
+    cv::morphologyEx(morph, mask, cv::MORPH_CLOSE, element_, cv::Point(-1, -1), 1,
+                     border, cv::morphologyDefaultBorderValue());
+
+    cv::GaussianBlur(mask, blur, cv::Size(5, 5), 0, 0, cv::BORDER_DEFAULT | cv::BORDER_ISOLATED);
+    cv::findContours(blur, buf.contours, buf.hierarchy, cv::RETR_TREE, cv::CHAIN_APPROX_SIMPLE, region.tl());
+
+    for (const auto& c : buf.contours) {
+        auto area_cnt = cv::contourArea(c);
+        if (area_cnt <= 500 || area_cnt >= 3000) {
+            continue;
+        }
+        cv::Moments M = cv::moments(c);
+        if (M.m00 == 0.0) {
+            continue;
+        }
+        int x_m = static_cast<int>(M.m10 / M.m00);
+        int y_m = static_cast<int>(M.m01 / M.m00);
+
+        int quadrant = slot_at(bin, cv::Point(x_m, y_m));
+        if (quadrant == -1 || !changed[quadrant - layout_[bin].first_slot]) {
+            continue;
+        }
+
+        if (contour_callback_) {
+            contour_callback_(bin, quadrant, buf.labels, buf.mask, c);
+        }
+        PartInfo part = detect_color(buf.labels, buf.mask, c, x_m, y_m);
+        if (part.color == -1) {
+            continue;
+        }
+        int slot = quadrant - layout_[bin].first_slot;
+        buf.part[slot] = static_cast<uint8_t>(part.type * 10 + part.color);
+        buf.confidence[slot] = color_confidence(buf, cv::boundingRect(c) & region, part.color);
+    }
+
+    // Only the reclassified slots get a new baseline, an unchanged slot keeps comparing against the
+    // frame its cached part was detected on, so slow drift still adds up to a change
+    for (int slot = 0; slot < 9; slot++) {
+        if (changed[slot]) {
+            img(buf.cells[slot]).copyTo(buf.previous(buf.cells[slot]));
+        }
+    }
+    buf.has_previous = true;
+}
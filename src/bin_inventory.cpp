@@ -0,0 +1,102 @@
+/**
+ * @copyright Copyright (c) 2023
+ * @file bin_inventory.cpp
+ * @author Sanchit Kedia (sanchit@terpmail.umd.edu)
+ * @author Adarsh Malapaka (amalapak@terpmail.umd.edu)
+ * @author Tanmay Haldankar (tanmayh@terpmail.umd.edu)
+ * @author Sahruday Patti (sahruday@umd.edu)
+ * @author Kshitij Karnawat (kshitij@umd.edu)
+ * @brief Implementation of the indexed bin part inventory for ARIAC 2023 (Group 3)
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ *
+ */
+#include "bin_inventory.hpp"
+
+BinInventory::BinInventory() : table_() {
+    table_.part.fill(uint8_t{BinSlotTable::kEmpty});
+}
+
+void BinInventory::set(int quadrant, int part_type_clr, const geometry_msgs::msg::Pose& pose) {
+    clear(quadrant);
+    if (quadrant < 1 || quadrant > kQuadrants) {
+        return;
+    }
+    int slot = quadrant - 1;
+    table_.pose[slot] = SlotPose::from_msg(pose);
+    revision_++;
+    if (part_type_clr < 0 || part_type_clr >= BinSlotTable::kEmpty) {
+        return;
+    }
+    table_.part[slot] = static_cast<uint8_t>(part_type_clr);
+    table_.occupied.set(slot);
+    allocator_.occupy(slot);
+    int index = BinSlotTable::part_index(part_type_clr);
+    if (index != -1) {
+        table_.by_part[index].set(slot);
+    }
+}
+
+void BinInventory::clear(int quadrant) {
+    if (quadrant < 1 || quadrant > kQuadrants) {
+        return;
+    }
+    int slot = quadrant - 1;
+    if (table_.part[slot] == BinSlotTable::kEmpty) {
+        return;
+    }
+    int index = BinSlotTable::part_index(table_.part[slot]);
+    if (index != -1) {
+        table_.by_part[index].reset(slot);
+    }
+    table_.part[slot] = BinSlotTable::kEmpty;
+    table_.occupied.reset(slot);
+    revision_++;
+    allocator_.release(slot);
+}
+
+int BinInventory::find(int part_type_clr) const {
+    int slot = candidates(part_type_clr).first();
+    return slot == -1 ? -1 : slot + 1;
+}
+
+int BinInventory::nearest(int part_type_clr, const SlotTravelCost& cost, const SlotMask& excluded) const {
+    int best = -1;
+    double best_cost = 0.0;
+    candidates(part_type_clr).without(excluded).for_each([&](int slot) {
+        double c = cost(slot);
+        if (best == -1 || c < best_cost) {
+            best = slot;
+            best_cost = c;
+        }
+    });
+    return best == -1 ? -1 : best + 1;
+}
+
+int BinInventory::allocate(const SlotTravelCost& cost) {
+    bool right_closer = std::abs(cost.rail_position - cost.right_bins_rail) <= std::abs(cost.rail_position - cost.left_bins_rail);
+    int slot = allocator_.acquire(right_closer ? SlotAllocator::kRightBins : SlotAllocator::kLeftBins);
+    return slot == -1 ? -1 : slot + 1;
+}
+
+SlotMask BinInventory::candidates(int part_type_clr) const {
+    if (part_type_clr == -1) {
+        return table_.free();
+    }
+    int index = BinSlotTable::part_index(part_type_clr);
+    return index == -1 ? SlotMask() : table_.by_part[index];
+}
+
+BinQuadrant BinInventory::operator[](int quadrant) const {
+    BinQuadrant entry;
+    if (quadrant < 1 || quadrant > kQuadrants) {
+        return entry;
+    }
+    int slot = quadrant - 1;
+    if (table_.part[slot] != BinSlotTable::kEmpty) {
+        entry.part_type_clr = table_.part[slot];
+    }
+    entry.part_pose = table_.pose[slot].to_msg();
+    return entry;
+}
@@ -0,0 +1,130 @@
+/**
+ * @copyright Copyright (c) 2023
+ * @file cell_snapshot.cpp
+ * @author Sanchit Kedia (sanchit@terpmail.umd.edu)
+ * @author Adarsh Malapaka (amalapak@terpmail.umd.edu)
+ * @author Tanmay Haldankar (tanmayh@terpmail.umd.edu)
+ * @author Sahruday Patti (sahruday@umd.edu)
+ * @author Kshitij Karnawat (kshitij@umd.edu)
+ * @brief Implementation of the workcell inventory snapshot for ARIAC 2023 (Group 3)
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ *
+ */
+#include "cell_snapshot.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+BinSlotTable empty_bins() {
+    BinSlotTable table{};
+    table.part.fill(uint8_t{BinSlotTable::kEmpty});
+    return table;
+}
+
+int bin_part(const BinSlotTable& table, int slot) {
+    return table.occupied.test(slot) ? table.part[slot] : -1;
+}
+
+bool same_pose(const geometry_msgs::msg::Pose& a, const geometry_msgs::msg::Pose& b) {
+    return a.position.x == b.position.x && a.position.y == b.position.y && a.position.z == b.position.z &&
+           a.orientation.x == b.orientation.x && a.orientation.y == b.orientation.y &&
+           a.orientation.z == b.orientation.z && a.orientation.w == b.orientation.w;
+}
+
+void diff_bins(const BinSlotTable& a, const BinSlotTable& b, std::vector<CellChange>& changes) {
+    // A slot changed when its part differs, or when it stays occupied and its pose moved
+    for (int slot = 0; slot < BinSlotTable::kSlots; slot++) {
+        int before = bin_part(a, slot);
+        int after = bin_part(b, slot);
+        if (before != after ||
+            (after != -1 && std::memcmp(&a.pose[slot], &b.pose[slot], sizeof(SlotPose)) != 0)) {
+            changes.push_back({CellChange::Area::kBin, slot + 1, before, after});
+        }
+    }
+}
+
+void diff_conveyor(const std::vector<int>& a, const std::vector<int>& b, std::vector<CellChange>& changes) {
+    size_t size = std::max(a.size(), b.size());
+    for (size_t i = 0; i < size; i++) {
+        int before = i < a.size() ? a[i] : -1;
+        int after = i < b.size() ? b[i] : -1;
+        if (before != after) {
+            changes.push_back({CellChange::Area::kConveyor, static_cast<int>(i), before, after});
+        }
+    }
+}
+
+void diff_kit_trays(const KitTrayModel& a, const KitTrayModel& b, std::vector<CellChange>& changes) {
+    for (int agv = 1; agv <= KitTrayModel::kAgvs; agv++) {
+        for (int quadrant = 1; quadrant <= KitTrayModel::kQuadrants; quadrant++) {
+            const KitTrayModel::TrayPart& before = a.at(agv, quadrant);
+            const KitTrayModel::TrayPart& after = b.at(agv, quadrant);
+            if (before.part_type_clr != after.part_type_clr ||
+                (after.part_type_clr != -1 && (before.quality != after.quality || !same_pose(before.pose, after.pose)))) {
+                changes.push_back({CellChange::Area::kKitTray, agv*10 + quadrant, before.part_type_clr, after.part_type_clr});
+            }
+        }
+    }
+}
+
+}  // namespace
+
+CellSnapshot::CellSnapshot()
+    : bins_(std::make_shared<const BinSlotTable>(empty_bins())),
+      conveyor_(std::make_shared<const std::vector<int>>()),
+      kit_trays_(std::make_shared<const KitTrayModel>()),
+      grippers_(std::make_shared<const GripperParts>()) {}
+
+CellSnapshot CellSnapshot::with_bins(const BinSlotTable& bins) const {
+    CellSnapshot next(*this);
+    next.version_++;
+    next.bins_ = std::make_shared<const BinSlotTable>(bins);
+    return next;
+}
+
+CellSnapshot CellSnapshot::with_conveyor(const std::vector<int>& conveyor) const {
+    CellSnapshot next(*this);
+    next.version_++;
+    next.conveyor_ = std::make_shared<const std::vector<int>>(conveyor);
+    return next;
+}
+
+CellSnapshot CellSnapshot::with_kit_trays(const KitTrayModel& kit_trays) const {
+    CellSnapshot next(*this);
+    next.version_++;
+    next.kit_trays_ = std::make_shared<const KitTrayModel>(kit_trays);
+    return next;
+}
+
+CellSnapshot CellSnapshot::with_grippers(const GripperParts& grippers) const {
+    CellSnapshot next(*this);
+    next.version_++;
+    next.grippers_ = std::make_shared<const GripperParts>(grippers);
+    return next;
+}
+
+std::vector<CellChange> diff(const CellSnapshot& a, const CellSnapshot& b) {
+    std::vector<CellChange> changes;
+    if (a.bins_ != b.bins_) {
+        diff_bins(*a.bins_, *b.bins_, changes);
+    }
+    if (a.conveyor_ != b.conveyor_) {
+        diff_conveyor(*a.conveyor_, *b.conveyor_, changes);
+    }
+    if (a.kit_trays_ != b.kit_trays_) {
+        diff_kit_trays(*a.kit_trays_, *b.kit_trays_, changes);
+    }
+    if (a.grippers_ != b.grippers_) {
+        if (a.grippers_->floor_part != b.grippers_->floor_part) {
+            changes.push_back({CellChange::Area::kGripper, 0, a.grippers_->floor_part, b.grippers_->floor_part});
+        }
+        if (a.grippers_->ceiling_part != b.grippers_->ceiling_part) {
+            changes.push_back({CellChange::Area::kGripper, 1, a.grippers_->ceiling_part, b.grippers_->ceiling_part});
+        }
+    }
+    return changes;
+}
@@ -0,0 +1,171 @@
+/**
+ * @copyright Copyright (c) 2023
+ * @file color_segmentation.cpp
+ * @author Sanchit Kedia (sanchit@terpmail.umd.edu)
+ * @author Adarsh Malapaka (amalapak@terpmail.umd.edu)
+ * @author Tanmay Haldankar (tanmayh@terpmail.umd.edu)
+ * @author Sahruday Patti (sahruday@umd.edu)
+ * @author Kshitij Karnawat (kshitij@umd.edu)
+ * @brief Implementation of single pass color segmentation for ARIAC 2023 (Group 3)
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ *
+ */
+#include "color_segmentation.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+constexpr int kHsvShift = 12;      // Fixed point shift used by OpenCV's 8-bit BGR2HSV
+constexpr int kLutBits = 5;        // Bits per channel kept by the 3D lookup table
+constexpr int kLutSize = 1 << (3 * kLutBits);
+constexpr uchar kCellMixed = 0x08; // Table cell spans more than one label, classify exactly
+
+constexpr uchar kHueColored = 0x08; // Hue lies in one of the bin part inRange() hue windows
+
+/**
+ * @brief Tables replicating cv::cvtColor(COLOR_BGR2HSV) for 8-bit images
+ *
+ */
+struct HsvTables {
+    int sdiv[256];
+    int hdiv[256];
+    uchar hue[256];  // detect_color() hue class | kHueColored
+};
+
+const HsvTables& hsv_tables() {
+    static const HsvTables tables = [] {
+        HsvTables t;
+        t.sdiv[0] = t.hdiv[0] = 0;
+        for (int i = 1; i < 256; i++) {
+            t.sdiv[i] = cv::saturate_cast<int>((255 << kHsvShift) / (1. * i));
+            t.hdiv[i] = cv::saturate_cast<int>((180 << kHsvShift) / (6. * i));
+        }
+        for (int h = 0; h < 256; h++) {
+            // Same hue tests, in the same order, as detect_color()
+            uchar clr = kLabelNoColor;
+            if (h > 10 && h < 25) {
+                clr = ariac_msgs::msg::Part::ORANGE;
+            } else if (h >= 130 && h < 170) {
+                clr = ariac_msgs::msg::Part::PURPLE;
+            } else if (h >= 90 && h < 130) {
+                clr = ariac_msgs::msg::Part::BLUE;
+            } else if (h <= 10) {
+                clr = ariac_msgs::msg::Part::RED;
+            } else if (h > 36 && h < 89) {
+                clr = ariac_msgs::msg::Part::GREEN;
+            }
+            // Hue windows of the red, red1, green, blue, orange and purple inRange() masks
+            bool colored = (h <= 10) || (h >= 170 && h <= 180) || (h >= 36 && h <= 70) ||
+                           (h >= 110 && h <= 130) || (h >= 6 && h <= 26) || (h >= 128 && h <= 148);
+            t.hue[h] = clr | (colored ? kHueColored : 0);
+        }
+        return t;
+    }();
+    return tables;
+}
+
+/**
+ * @brief Exact classification of one BGR pixel
+ *
+ */
+inline uchar classify_bgr(const HsvTables& t, int b, int g, int r) {
+    int v = std::max(b, std::max(g, r));
+    int vmin = std::min(b, std::min(g, r));
+    int diff = v - vmin;
+    int vr = v == r ? -1 : 0;
+    int vg = v == g ? -1 : 0;
+
+    int s = (diff * t.sdiv[v] + (1 << (kHsvShift - 1))) >> kHsvShift;
+    int h = (vr & (g - b)) + (~vr & ((vg & (b - r + 2 * diff)) + ((~vg) & (r - g + 4 * diff))));
+    h = (h * t.hdiv[diff] + (1 << (kHsvShift - 1))) >> kHsvShift;
+    h += h < 0 ? 180 : 0;
+    h = cv::saturate_cast<uchar>(h);
+
+    uchar hue = t.hue[h];
+    uchar label = hue & kLabelColorMask;
+    bool colored = (hue & kHueColored) && s >= 25 && v >= 25;
+    bool gray = h == 0 && v >= 32 && v <= 117;
+    if (colored || gray) {
+        label |= kLabelForeground;
+    }
+    if (gray && s == 0) {
+        label |= kLabelGray;
+    }
+    return label;
+}
+
+/**
+ * @brief 3D lookup table indexed by the top kLutBits of B, G and R
+ *
+ */
+const std::vector<uchar>& color_lut() {
+    static const std::vector<uchar> lut = [] {
+        const HsvTables& t = hsv_tables();
+        const int step = 1 << (8 - kLutBits);
+        std::vector<uchar> table(kLutSize);
+        for (int cell = 0; cell < kLutSize; cell++) {
+            int b0 = ((cell >> (2 * kLutBits)) & ((1 << kLutBits) - 1)) * step;
+            int g0 = ((cell >> kLutBits) & ((1 << kLutBits) - 1)) * step;
+            int r0 = (cell & ((1 << kLutBits) - 1)) * step;
+            uchar first = classify_bgr(t, b0, g0, r0);
+            uchar label = first;
+            for (int b = b0; b < b0 + step && label != kCellMixed; b++) {
+                for (int g = g0; g < g0 + step && label != kCellMixed; g++) {
+                    for (int r = r0; r < r0 + step; r++) {
+                        if (classify_bgr(t, b, g, r) != first) {
+                            label = kCellMixed;
+                            break;
+                        }
+                    }
+                }
+            }
+            table[cell] = label;
+        }
+        return table;
+    }();
+    return lut;
+}
+
+}  // namespace
+
+void segment_colors(const cv::Mat& bgr, cv::Mat& mask, cv::Mat& labels) {
+    CV_Assert(bgr.type() == CV_8UC3);
+    const HsvTables& t = hsv_tables();
+    const uchar* lut = color_lut().data();
+
+    mask.create(bgr.size(), CV_8UC1);
+    labels.create(bgr.size(), CV_8UC1);
+
+    int rows = bgr.rows;
+    int cols = bgr.cols;
+    if (bgr.isContinuous() && mask.isContinuous() && labels.isContinuous()) {
+        cols *= rows;
+        rows = 1;
+    }
+
+    for (int y = 0; y < rows; y++) {
+        const uchar* src = bgr.ptr<uchar>(y);
+        uchar* lbl = labels.ptr<uchar>(y);
+        uchar* msk = mask.ptr<uchar>(y);
+
+        for (int x = 0; x < cols; x++, src += 3) {
+            int cell = ((src[0] >> (8 - kLutBits)) << (2 * kLutBits)) |
+                       ((src[1] >> (8 - kLutBits)) << kLutBits) |
+                       (src[2] >> (8 - kLutBits));
+            uchar label = lut[cell];
+            if (label == kCellMixed) {
+                label = classify_bgr(t, src[0], src[1], src[2]);
+            }
+            lbl[x] = label;
+        }
+
+        // Branch free so the compiler can vectorize the mask expansion
+        for (int x = 0; x < cols; x++) {
+            msk[x] = static_cast<uchar>(static_cast<signed char>(lbl[x]) >> 7);
+        }
+    }
+}
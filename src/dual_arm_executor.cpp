@@ -0,0 +1,132 @@
+/**
+ * @copyright Copyright (c) 2023
+ * @file dual_arm_executor.cpp
+ * @author Sanchit Kedia (sanchit@terpmail.umd.edu)
+ * @author Adarsh Malapaka (amalapak@terpmail.umd.edu)
+ * @author Tanmay Haldankar (tanmayh@terpmail.umd.edu)
+ * @author Sahruday Patti (sahruday@umd.edu)
+ * @author Kshitij Karnawat (kshitij@umd.edu)
+ * @brief Implementation of the concurrent floor and ceiling robot execution for ARIAC 2023 (Group 3)
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ *
+ */
+#include "dual_arm_executor.hpp"
+
+#include <exception>
+#include <utility>
+
+WorkspaceReservations::AreaMask WorkspaceReservations::area(Area area) {
+    AreaMask mask;
+    mask.set(area);
+    return mask;
+}
+
+WorkspaceReservations::AreaMask WorkspaceReservations::bins(int quadrant) {
+    return area(quadrant < 37 ? kRightBins : kLeftBins);
+}
+
+WorkspaceReservations::AreaMask WorkspaceReservations::agv(int agv) {
+    if (agv < 1 || agv > 4) {
+        return AreaMask();
+    }
+    return area(static_cast<Area>(kAgv1 + agv - 1));
+}
+
+WorkspaceReservations::AreaMask WorkspaceReservations::station(int station) {
+    if (station < 1 || station > 4) {
+        return AreaMask();
+    }
+    return area(static_cast<Area>(kStation1 + station - 1));
+}
+
+void WorkspaceReservations::acquire(int holder, const AreaMask& areas) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    released_.wait(lock, [&] {
+        for (int other = 0; other < kHolders; other++) {
+            if (other != holder && (held_[other] & areas).any()) {
+                return false;
+            }
+        }
+        return true;
+    });
+    held_[holder] = areas;
+}
+
+void WorkspaceReservations::release(int holder) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        held_[holder].reset();
+    }
+    released_.notify_all();
+}
+
+WorkspaceReservations::AreaMask WorkspaceReservations::held(int holder) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return held_[holder];
+}
+
+DualArmExecutor::DualArmExecutor() {
+    for (int robot = 0; robot < static_cast<int>(workers_.size()); robot++) {
+        workers_[robot].thread = std::thread(&DualArmExecutor::work, this, robot);
+    }
+}
+
+DualArmExecutor::~DualArmExecutor() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    queued_.notify_all();
+    for (auto& worker : workers_) {
+        worker.thread.join();
+    }
+}
+
+std::future<bool> DualArmExecutor::submit(Arm arm, const WorkspaceReservations::AreaMask& areas, Action action) {
+    Job job{areas, std::move(action), std::promise<bool>()};
+    std::future<bool> done = job.done.get_future();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        workers_[static_cast<int>(arm)].jobs.push_back(std::move(job));
+    }
+    queued_.notify_all();
+    return done;
+}
+
+bool DualArmExecutor::idle(Arm arm) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const Worker& worker = workers_[static_cast<int>(arm)];
+    return !worker.busy && worker.jobs.empty();
+}
+
+void DualArmExecutor::work(int robot) {
+    Worker& worker = workers_[robot];
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            queued_.wait(lock, [&] { return stop_ || !worker.jobs.empty(); });
+            if (stop_) {
+                return;
+            }
+            job = std::move(worker.jobs.front());
+            worker.jobs.pop_front();
+            worker.busy = true;
+        }
+
+        reservations_.acquire(robot, job.areas);
+        try {
+            job.done.set_value(job.action());
+        } catch (...) {
+            job.done.set_exception(std::current_exception());
+        }
+        reservations_.release(robot);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            worker.busy = false;
+        }
+    }
+}
@@ -0,0 +1,36 @@
+/**
+ * @copyright Copyright (c) 2023
+ * @file inventory_readiness.cpp
+ * @author Sanchit Kedia (sanchit@terpmail.umd.edu)
+ * @author Adarsh Malapaka (amalapak@terpmail.umd.edu)
+ * @author Tanmay Haldankar (tanmayh@terpmail.umd.edu)
+ * @author Sahruday Patti (sahruday@umd.edu)
+ * @author Kshitij Karnawat (kshitij@umd.edu)
+ * @brief Implementation of bin inventory readiness signalling for ARIAC 2023 (Group 3)
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ *
+ */
+#include "inventory_readiness.hpp"
+
+void InventoryReadiness::notify(int source, int64_t stamp) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stamps_[source] = stamp;
+    }
+    cv_.notify_all();
+}
+
+bool InventoryReadiness::wait_newer(const Stamps& after, std::chrono::milliseconds timeout) const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return cv_.wait_for(lock, timeout, [&] {
+        for (int source = 0; source < kSources; source++) {
+            // A stamp of -1 means no detection yet, even when any detection is accepted
+            if (stamps_[source] < 0 || stamps_[source] <= after[source]) {
+                return false;
+            }
+        }
+        return true;
+    });
+}
@@ -0,0 +1,119 @@
+/**
+ * @copyright Copyright (c) 2023
+ * @file kit_tray_model.cpp
+ * @author Sanchit Kedia (sanchit@terpmail.umd.edu)
+ * @author Adarsh Malapaka (amalapak@terpmail.umd.edu)
+ * @author Tanmay Haldankar (tanmayh@terpmail.umd.edu)
+ * @author Sahruday Patti (sahruday@umd.edu)
+ * @author Kshitij Karnawat (kshitij@umd.edu)
+ * @brief Implementation of the per AGV kit tray occupancy model for ARIAC 2023 (Group 3)
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ *
+ */
+#include "kit_tray_model.hpp"
+
+KitTrayModel::KitTrayModel() {
+    reusable_.fill(0);
+}
+
+int KitTrayModel::cell(int agv, int quadrant) {
+    if (agv < 1 || agv > kAgvs || quadrant < 1 || quadrant > kQuadrants) {
+        return -1;
+    }
+    return (agv - 1) * kQuadrants + (quadrant - 1);
+}
+
+bool KitTrayModel::place(int agv, int quadrant, int part_type_clr, const geometry_msgs::msg::Pose& pose,
+                         const std::string& order_id) {
+    int c = cell(agv, quadrant);
+    if (c == -1) {
+        return false;
+    }
+    remove(agv, quadrant);
+    cells_[c].part_type_clr = part_type_clr;
+    cells_[c].pose = pose;
+    cells_[c].order_id = order_id;
+    cells_[c].quality = Quality::kUnchecked;
+    revision_++;
+    int index = BinSlotTable::part_index(part_type_clr);
+    if (index != -1) {
+        reusable_[index] |= static_cast<uint16_t>(1u << c);
+    }
+    return true;
+}
+
+void KitTrayModel::remove(int agv, int quadrant) {
+    int c = cell(agv, quadrant);
+    if (c == -1 || cells_[c].part_type_clr == -1) {
+        return;
+    }
+    int index = BinSlotTable::part_index(cells_[c].part_type_clr);
+    if (index != -1) {
+        reusable_[index] &= static_cast<uint16_t>(~(1u << c));
+    }
+    cells_[c] = TrayPart();
+    revision_++;
+}
+
+void KitTrayModel::clear(int agv) {
+    for (int quadrant = 1; quadrant <= kQuadrants; quadrant++) {
+        remove(agv, quadrant);
+    }
+}
+
+void KitTrayModel::set_quality(int agv, int quadrant, Quality quality) {
+    int c = cell(agv, quadrant);
+    if (c == -1 || cells_[c].part_type_clr == -1) {
+        return;
+    }
+    cells_[c].quality = quality;
+    revision_++;
+    int index = BinSlotTable::part_index(cells_[c].part_type_clr);
+    if (index == -1) {
+        return;
+    }
+    if (quality == Quality::kFaulty) {
+        reusable_[index] &= static_cast<uint16_t>(~(1u << c));
+    } else {
+        reusable_[index] |= static_cast<uint16_t>(1u << c);
+    }
+}
+
+const KitTrayModel::TrayPart& KitTrayModel::at(int agv, int quadrant) const {
+    int c = cell(agv, quadrant);
+    return c == -1 ? empty_ : cells_[c];
+}
+
+KitTrayModel::Location KitTrayModel::find(int part_type_clr, const std::string& order_id) const {
+    int index = BinSlotTable::part_index(part_type_clr);
+    if (index == -1) {
+        return Location();
+    }
+    for (unsigned bits = reusable_[index]; bits != 0; bits &= bits - 1) {
+        int c = __builtin_ctz(bits);
+        if (cells_[c].order_id != order_id) {
+            return {c / kQuadrants + 1, c % kQuadrants + 1};
+        }
+    }
+    return Location();
+}
+
+std::vector<int> KitTrayModel::reusable_parts() const {
+    std::vector<int> parts;
+    for (const auto& part : cells_) {
+        if (part.part_type_clr != -1 && part.quality != Quality::kFaulty) {
+            parts.push_back(part.part_type_clr);
+        }
+    }
+    return parts;
+}
+
+int KitTrayModel::size() const {
+    int count = 0;
+    for (const auto& part : cells_) {
+        count += part.part_type_clr != -1 ? 1 : 0;
+    }
+    return count;
+}
@@ -0,0 +1,107 @@
+/**
+ * @copyright Copyright (c) 2023
+ * @file part_detector.cpp
+ * @author Sanchit Kedia (sanchit@terpmail.umd.edu)
+ * @author Adarsh Malapaka (amalapak@terpmail.umd.edu)
+ * @author Tanmay Haldankar (tanmayh@terpmail.umd.edu)
+ * @author Sahruday Patti (sahruday@umd.edu)
+ * @author Kshitij Karnawat (kshitij@umd.edu)
+ * @brief Implementation of the composable part detector node for ARIAC 2023 (Group 3)
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ *
+ */
+#include "part_detector.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+#include <rclcpp_components/register_node_macro.hpp>
+
+PartDetector::PartDetector(const rclcpp::NodeOptions& options)
+    : Node("part_detector", options) {
+    // Bins of a camera are processed concurrently, and each camera has its own callback
+    // group so a multi-threaded executor runs both cameras at the same time
+    bool parallel_bins = this->declare_parameter<bool>("parallel_bins", true);
+    right_bins_detector_.set_parallel(parallel_bins);
+    left_bins_detector_.set_parallel(parallel_bins);
+
+    // Only slots whose pixels changed since the previous frame are reclassified
+    bool incremental_bins = this->declare_parameter<bool>("incremental_bins", true);
+    right_bins_detector_.set_incremental(incremental_bins);
+    left_bins_detector_.set_incremental(incremental_bins);
+
+    auto camera_qos = rclcpp::QoS(rclcpp::KeepLast(1)).best_effort().durability_volatile();
+
+    rclcpp::SubscriptionOptions right_options;
+    right_bins_cb_group_ = create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive);
+    right_options.callback_group = right_bins_cb_group_;
+
+    rclcpp::SubscriptionOptions left_options;
+    left_bins_cb_group_ = create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive);
+    left_options.callback_group = left_bins_cb_group_;
+
+    right_bins_rgb_camera_sub_ = this->create_subscription<sensor_msgs::msg::Image>(
+        "/ariac/sensors/right_bins_rgb_camera/rgb_image", camera_qos,
+        std::bind(&PartDetector::right_bins_rgb_camera_cb, this, std::placeholders::_1), right_options);
+
+    left_bins_rgb_camera_sub_ = this->create_subscription<sensor_msgs::msg::Image>(
+        "/ariac/sensors/left_bins_rgb_camera/rgb_image", camera_qos,
+        std::bind(&PartDetector::left_bins_rgb_camera_cb, this, std::placeholders::_1), left_options);
+
+    conv_rgb_camera_sub_ = this->create_subscription<sensor_msgs::msg::Image>(
+        "/ariac/sensors/conv_rgb_camera/rgb_image", camera_qos,
+        std::bind(&PartDetector::conv_rgb_camera_cb, this, std::placeholders::_1));
+
+    right_part_detector_pub_ = this->create_publisher<group3::msg::BinSlots>("/right_bin_part_detector", 10);
+    left_part_detector_pub_ = this->create_publisher<group3::msg::BinSlots>("/left_bin_part_detector", 10);
+    conv_part_detector_pub_ = this->create_publisher<group3::msg::Part>("/conveyor_part_detector", 10);
+}
+
+void PartDetector::right_bins_rgb_camera_cb(const sensor_msgs::msg::Image::ConstSharedPtr msg) {
+    publish_bin_parts(right_bins_detector_, right_bins_slots_, msg, right_bins_sequence_, right_part_detector_pub_);
+}
+
+void PartDetector::left_bins_rgb_camera_cb(const sensor_msgs::msg::Image::ConstSharedPtr msg) {
+    publish_bin_parts(left_bins_detector_, left_bins_slots_, msg, left_bins_sequence_, left_part_detector_pub_);
+}
+
+void PartDetector::publish_bin_parts(BinGridDetector& detector,
+                                     BinSlotDetections& slots,
+                                     const sensor_msgs::msg::Image::ConstSharedPtr& msg,
+                                     uint32_t& sequence,
+                                     const rclcpp::Publisher<group3::msg::BinSlots>::SharedPtr& publisher) {
+    static_assert(BinSlotDetections::kMaxSlots == group3::msg::BinSlots::SLOTS, "BinSlots layout mismatch");
+    static_assert(BinSlotDetections::kEmpty == group3::msg::BinSlots::EMPTY, "BinSlots layout mismatch");
+
+    cv::Mat frame = cv_bridge::toCvShare(msg, "bgr8")->image;
+    detector.detect({frame}, slots);
+
+    // Fixed size arrays, no per-part allocation. The RGB detector has no refined poses
+    auto slots_msg = std::make_unique<group3::msg::BinSlots>();
+    slots_msg->header = msg->header;
+    slots_msg->sequence = ++sequence;
+    slots_msg->first_quadrant = static_cast<uint8_t>(slots.first_quadrant);
+    slots_msg->occupied = slots.occupied;
+    slots_msg->refined = 0;
+    std::copy(slots.part.begin(), slots.part.end(), slots_msg->part.begin());
+    std::copy(slots.confidence.begin(), slots.confidence.end(), slots_msg->confidence.begin());
+
+    publisher->publish(std::move(slots_msg));
+}
+
+void PartDetector::conv_rgb_camera_cb(const sensor_msgs::msg::Image::ConstSharedPtr msg) {
+    cv::Mat frame = cv_bridge::toCvShare(msg, "bgr8")->image;
+
+    for (const auto& info : conveyor(frame)) {
+        auto part = std::make_unique<group3::msg::Part>();
+        part->color = info[0];
+        part->type = info[1];
+        part->quad = info[2];
+        conv_part_detector_pub_->publish(std::move(part));
+    }
+}
+
+RCLCPP_COMPONENTS_REGISTER_NODE(PartDetector)
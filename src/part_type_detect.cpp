@@ -13,21 +13,130 @@
  * 
  */
 #include "part_type_detect.hpp"
+#include "bin_grid_detector.hpp"
 
-int detect_type(cv::Mat img, std::vector<cv::Point> cnt) {
-    int type;
+#include <algorithm>
+
+namespace {
+
+/**
+ * @brief Per thread buffers reused by detect_type() across parts and frames
+ *
+ */
+struct TypeScratch {
+    cv::Mat gray;     // Backing store of the gray crop, grown to the largest crop seen
+    cv::Mat closed;   // Backing store of the closed gray crop
+    cv::Mat element = cv::Mat::ones(3, 3, CV_8U);
+    std::vector<std::vector<cv::Point>> contours;
+    std::vector<cv::Vec4i> hierarchy;
+
+    /**
+     * @brief Return views of the two crop buffers, growing them if needed
+     *
+     */
+    void views(cv::Size size, cv::Mat& gray_view, cv::Mat& closed_view) {
+        if (gray.rows < size.height || gray.cols < size.width) {
+            cv::Size grown(std::max(gray.cols, size.width), std::max(gray.rows, size.height));
+            gray.create(grown, CV_8U);
+            closed.create(grown, CV_8U);
+        }
+        gray_view = gray(cv::Rect(cv::Point(0, 0), size));
+        closed_view = closed(cv::Rect(cv::Point(0, 0), size));
+    }
+};
+
+thread_local TypeScratch type_scratch;
+
+}  // namespace
+
+int detect_type(const cv::Mat& labels, const cv::Mat& mask, const std::vector<cv::Point>& cnt) {
+    int type = 0;
     cv::Rect rect = cv::boundingRect(cnt);
-    int x = rect.x;
-    int y = rect.y;
-    int w = rect.width;
-    int h = rect.height;
 
+    // Area inside the bounding box, offset by one pixel as in the original crop
+    cv::Rect crop = cv::Rect(rect.x + 1, rect.y + 1, rect.width, rect.height) &
+                    cv::Rect(0, 0, labels.cols, labels.rows);
+    if (crop.empty()) {
+        return type;
+    }
+
+    TypeScratch& scratch = type_scratch;
+    cv::Mat gray, closed;
+    scratch.views(crop.size(), gray, closed);
+
+    // Gray (H = 0, S = 0, 32 <= V <= 117) pixels of the masked part image
+    for (int y = 0; y < crop.height; y++) {
+        const uchar* lbl = labels.ptr<uchar>(crop.y + y) + crop.x;
+        const uchar* msk = mask.ptr<uchar>(crop.y + y) + crop.x;
+        uchar* dst = gray.ptr<uchar>(y);
+        for (int x = 0; x < crop.width; x++) {
+            dst[x] = (lbl[x] & kLabelGray) && msk[x] ? 255 : 0;
+        }
+    }
+
+    // The bounding box outline drawn on the part image is never gray
+    cv::rectangle(gray, cv::Rect(rect.x - crop.x, rect.y - crop.y, rect.width, rect.height), cv::Scalar(0), 2);
+
+    // Crop buffers are views, BORDER_ISOLATED keeps the filter from reading past them
+    cv::morphologyEx(gray, closed, cv::MORPH_CLOSE, scratch.element, cv::Point(-1, -1), 2,
+                     cv::BORDER_CONSTANT | cv::BORDER_ISOLATED, cv::morphologyDefaultBorderValue());
+
+    cv::findContours(closed, scratch.contours, scratch.hierarchy, cv::RETR_TREE, cv::CHAIN_APPROX_SIMPLE);
+
+    int count = 0;
+    double area_gray = 0;
+    double perimeter = cv::arcLength(cnt, true);
+
+    for (const auto& c : scratch.contours) {
+        area_gray = cv::contourArea(c);
+        if (area_gray > 10) {
+            count += 1;
+        }
+    }
+
+    if (count == 2) {
+        type = ariac_msgs::msg::Part::REGULATOR; //13 - Regulator
+    } else if (count == 1) {
+        if (perimeter < 155 && 57 < area_gray && area_gray < 214) {
+            type = ariac_msgs::msg::Part::BATTERY; //10 - Battery
+        } else if (area_gray < 20) {
+            type = ariac_msgs::msg::Part::PUMP;   //11 - Pump
+        } else if (perimeter > 151 && 23 < area_gray  && area_gray < 203) {
+            type = ariac_msgs::msg::Part::SENSOR;  //12 - Sensor
+        }
+    } else if (count == 0) {
+        type = ariac_msgs::msg::Part::PUMP;  //11 - Pump
+    }
+
+    return type;
+}
+
+PartInfo detect_color(const cv::Mat& labels, const cv::Mat& mask, const std::vector<cv::Point>& c, int x_m, int y_m){
+    PartInfo info;
+    info.color = label_color(labels.at<uchar>(y_m, x_m));
+    if (info.color != -1) {
+        info.type = detect_type(labels, mask, c);
+    }
+    return info;
+}
+
+std::vector<std::vector<int>> rightbin(cv::Mat img){
+    thread_local BinGridDetector detector(right_bins_layout());
+    return detector.detect({img});
+}
+
+std::vector<std::vector<int>> leftbin(cv::Mat img){
+    thread_local BinGridDetector detector(left_bins_layout());
+    return detector.detect({img});
+}
+
+int conveyor_detect_type(cv::Mat img, std::vector<cv::Point> cnt) {
+    int type = 0;
+    cv::Rect rect = cv::boundingRect(cnt);
     cv::rectangle(img, rect, cv::Scalar(0, 255, 0), 2);
 
-    cv::Mat im = img.clone();
-    im = im(cv::Range(y+1,y+h+1), cv::Range(x+1,x+w+1));
     cv::Mat im_hsv;
-    cv::cvtColor(im.clone(), im_hsv, cv::COLOR_BGR2HSV);
+    cv::cvtColor(img, im_hsv, cv::COLOR_BGR2HSV);
 
     cv::Scalar lower_gray(0, 0, 32);
     cv::Scalar upper_gray(0, 0, 117);
@@ -35,345 +144,104 @@ int detect_type(cv::Mat img, std::vector<cv::Point> cnt) {
     cv::inRange(im_hsv, lower_gray, upper_gray, mask);
 
     cv::Mat element = cv::Mat::ones(3, 3, CV_8U);
-
-    // cv::morphologyEx(mask, mask, cv::MORPH_CLOSE, element, cv::Point(-1,-1), 2);
-    cv::dilate(mask, mask, element, cv::Point(-1, -1));
-    cv::dilate(mask, mask, element, cv::Point(-1, -1));
-    cv::erode(mask, mask, element, cv::Point(-1, -1));
-    cv::erode(mask, mask, element, cv::Point(-1, -1));
+    cv::morphologyEx(mask, mask, cv::MORPH_CLOSE, element, cv::Point(-1, -1), 2);
 
     std::vector<std::vector<cv::Point>> contours;
     std::vector<cv::Vec4i> hierarchy;
     cv::findContours(mask, contours, hierarchy, cv::RETR_TREE, cv::CHAIN_APPROX_SIMPLE);
-    
-    int count = 0;
 
-    double area_gray;
-    double perimeter;
+    int count = 0;
+    double area_gray = 0;
+    double perimeter = cv::arcLength(cnt, true);
 
     for (auto c : contours) {
         area_gray = cv::contourArea(c);
-        perimeter = cv::arcLength(cnt, true);
         if (area_gray > 10) {
             count += 1;
-        } 
+        }
     }
 
     if (count == 2) {
         type = ariac_msgs::msg::Part::REGULATOR; //13 - Regulator
     } else if (count == 1) {
-        if (perimeter < 155 && 57 < area_gray && area_gray < 214) {
+        if (perimeter < 250) {
             type = ariac_msgs::msg::Part::BATTERY; //10 - Battery
-        } else if (area_gray < 20) {
+        } else if (area_gray < 25) {
             type = ariac_msgs::msg::Part::PUMP;   //11 - Pump
-        } else if (perimeter > 151 && 23 < area_gray  && area_gray < 203) {
+        } else if (perimeter > 250) {
             type = ariac_msgs::msg::Part::SENSOR;  //12 - Sensor
         }
-    } else if (count == 0) {
+    } else {
         type = ariac_msgs::msg::Part::PUMP;  //11 - Pump
-    } 
+    }
 
     return type;
 }
 
+std::vector<std::vector<int>> conveyor(cv::Mat img){
+    std::vector<std::vector<int>> conveyor_info;
 
-std::vector<int> detect_color(cv::Mat img, cv::Mat new_image, std::vector<cv::Point> c, int x_m, int y_m){
-
-    int part_clr;
-    int part_type;
-    std::vector<int> clr_type;
+    cv::Mat img_conv = img(cv::Range(150,479), cv::Range(225,443));
     cv::Mat img_hsv;
-    cv::cvtColor(img.clone(), img_hsv, cv::COLOR_BGR2HSV);
-    
-    cv::Vec3b hsv = img_hsv.at<cv::Vec3b>(y_m, x_m);
-    
-    if (hsv[0]>10 && hsv[0]<25) {
-        part_clr = ariac_msgs::msg::Part::ORANGE;  // 3 - Orange
-        part_type = detect_type(new_image.clone(), c);
-    } else if(hsv[0]>=130 && hsv[0]<170) {
-        part_clr = ariac_msgs::msg::Part::PURPLE;  // 4 - Purple
-        part_type = detect_type(new_image.clone(), c);
-    } else if (hsv[0]>=90 && hsv[0]<130) {
-        part_clr = ariac_msgs::msg::Part::BLUE;  // 2 - Blue
-        part_type = detect_type(new_image.clone(), c);
-    } else if (hsv[0]>=0 && hsv[0]<=10) { 
-        part_clr = ariac_msgs::msg::Part::RED;  // 0 - Red
-        part_type = detect_type(new_image.clone(), c);
-    } else if (hsv[0]>36 && hsv[0]<89) {
-        part_clr = ariac_msgs::msg::Part::GREEN;  // 1 - Green  
-        part_type = detect_type(new_image.clone(), c);
-    }
-    clr_type.push_back(part_clr);
-    clr_type.push_back(part_type);
+    cv::cvtColor(img_conv, img_hsv, cv::COLOR_BGR2HSV);
+
+    // Saturation floor is higher than in the bins to reject the conveyor belt
+    cv::Mat mask, part_mask;
+    cv::inRange(img_hsv, cv::Scalar(0, 55, 25), cv::Scalar(10, 255, 255), mask);     // Red
+    cv::inRange(img_hsv, cv::Scalar(170, 55, 25), cv::Scalar(180, 255, 255), part_mask);   // Red
+    mask |= part_mask;
+    cv::inRange(img_hsv, cv::Scalar(36, 55, 25), cv::Scalar(70, 255, 255), part_mask);     // Green
+    mask |= part_mask;
+    cv::inRange(img_hsv, cv::Scalar(110, 55, 25), cv::Scalar(130, 255, 255), part_mask);   // Blue
+    mask |= part_mask;
+    cv::inRange(img_hsv, cv::Scalar(6, 55, 25), cv::Scalar(26, 255, 255), part_mask);     // Orange
+    mask |= part_mask;
+    cv::inRange(img_hsv, cv::Scalar(128, 55, 25), cv::Scalar(148, 255, 255), part_mask);   // Purple
+    mask |= part_mask;
+    cv::inRange(img_hsv, cv::Scalar(0, 0, 32), cv::Scalar(0, 255, 117), part_mask);      // Gray
+    mask |= part_mask;
 
-    return clr_type;
-}
-    
+    cv::Mat element = cv::Mat::ones(3, 3, CV_8U);
+    cv::morphologyEx(mask, mask, cv::MORPH_OPEN, element, cv::Point(-1, -1), 1);
+    cv::morphologyEx(mask, mask, cv::MORPH_CLOSE, element, cv::Point(-1, -1), 1);
 
-std::vector<std::vector<int>> rightbin(cv::Mat img){
-    std::vector<std::vector<int>> right_bin_info;
-    std::vector<int> part_info;
-
-    cv::Mat img_bin_tr = img(cv::Range(28,223), cv::Range(356,548));
-    cv::Mat img_bin_tl = img(cv::Range(28,223), cv::Range(118,308));
-    cv::Mat img_bin_br = img(cv::Range(267,458), cv::Range(356,548));
-    cv::Mat img_bin_bl = img(cv::Range(267,458), cv::Range(118,308));
-
-    std::vector<cv::Mat> image{img_bin_br, img_bin_bl, img_bin_tl, img_bin_tr};
-    int i = 0;
-
-    for (auto img : image) {
-        cv::Mat img_hsv;
-        cv::cvtColor(img.clone(), img_hsv, cv::COLOR_BGR2HSV);
-
-        cv::Scalar lower_red(0, 25, 25);
-        cv::Scalar upper_red(10, 255, 255);
-        cv::Scalar lower_red1(170, 25, 25);
-        cv::Scalar upper_red1(180, 255, 255);
-
-        cv::Scalar lower_green(36, 25, 25);
-        cv::Scalar upper_green(70, 255, 255);
-
-        cv::Scalar lower_blue(110, 25, 25);
-        cv::Scalar upper_blue(130, 255, 255);
-
-        cv::Scalar lower_orange(6, 25, 25);
-        cv::Scalar upper_orange(26, 255, 255);
-
-        cv::Scalar lower_purple(128, 25, 25);
-        cv::Scalar upper_purple(148, 255, 255);
-
-        cv::Scalar lower_gray(0, 0, 32);
-        cv::Scalar upper_gray(0, 255, 117);
-        
-        cv::Mat mask1, mask11;
-        cv::inRange(img_hsv, lower_red, upper_red, mask1);
-        cv::inRange(img_hsv, lower_red1, upper_red1, mask11);
-        
-        cv::Mat mask2;
-        cv::inRange(img_hsv, lower_green, upper_green, mask2);
-        
-        cv::Mat mask3;
-        cv::inRange(img_hsv, lower_blue, upper_blue, mask3);
-
-        cv::Mat mask4;
-        cv::inRange(img_hsv, lower_orange, upper_orange, mask4);
-
-        cv::Mat mask5;
-        cv::inRange(img_hsv, lower_purple, upper_purple, mask5);
-        
-        cv::Mat mask6;
-        cv::inRange(img_hsv, lower_gray, upper_gray, mask6);
-
-        cv::Mat mask = mask1 + mask11 + mask2 + mask3 + mask4 + mask5 + mask6;
-
-        cv::Mat element = cv::Mat::ones(3, 3, CV_8U);
-
-        // cv::morphologyEx(mask, mask, cv::MORPH_OPEN, element, cv::Point(-1,-1), 2);
-        cv::erode(mask, mask, element, cv::Point(-1, -1));
-        cv::erode(mask, mask, element, cv::Point(-1, -1));
-        cv::dilate(mask, mask, element, cv::Point(-1, -1));
-        cv::dilate(mask, mask, element, cv::Point(-1, -1));
-
-        // cv::morphologyEx(mask, mask, cv::MORPH_CLOSE, element, cv::Point(-1,-1), 1);
-        cv::dilate(mask, mask, element, cv::Point(-1, -1));
-        cv::erode(mask, mask, element, cv::Point(-1, -1));
-        
-        cv::Mat new_image;
-        cv::bitwise_and(img, img, new_image, mask);
-
-        cv::Mat blur;
-        cv::GaussianBlur(mask, blur, cv::Size(5, 5), 0);
-
-        std::vector<std::vector<cv::Point>> contours;
-        std::vector<cv::Vec4i> hierarchy;
-        cv::findContours(blur, contours, hierarchy, cv::RETR_TREE, cv::CHAIN_APPROX_SIMPLE);
-
-        int x_m;
-        int y_m;
-        int quadrant;
-
-        for (auto c : contours) {
-            auto area_cnt = cv::contourArea(c);
-            cv::Moments M = cv::moments(c);
-            if (M.m00 != 0.0) { 
-                cv::Point p(M.m10/M.m00, M.m01/M.m00);
-                x_m = int(p.x);
-                y_m = int(p.y);
-            }
-
-            if (area_cnt > 500 && area_cnt < 3000) {
-                if ((137<=x_m && x_m<=195) &&  (130<=y_m && y_m<=192)){
-                    quadrant =  9*i + 9;
-                }
-                else if ((0<=x_m && x_m<=70) &&  (0<=y_m && y_m<=65)){
-                    quadrant =  9*i + 1;
-                }
-                else if ((71<=x_m && x_m<=135) &&  (0<=y_m && y_m<=65)){
-                    quadrant =  9*i + 2;
-                }
-                else if ((137<=x_m && x_m<=195) &&  (0<=y_m && y_m<=65)){
-                    quadrant =  9*i + 3;
-                }
-                else if ((0<=x_m && x_m<=70) &&  (69<=y_m && y_m<=126)){
-                    quadrant =  9*i + 4;
-                }
-                else if ((71<=x_m && x_m<=135) &&  (69<=y_m && y_m<=126)){
-                    quadrant =  9*i + 5;
-                }
-                else if ((137<=x_m && x_m<=195) &&  (69<=y_m && y_m<=126)){
-                    quadrant =  9*i + 6;
-                }
-                else if ((0<=x_m && x_m<=70) &&  (130<=y_m && y_m<=192)){
-                    quadrant =  9*i + 7;
-                }
-                else if ((71<=x_m && x_m<=135) &&  (130<=y_m && y_m<=192)){
-                    quadrant =  9*i + 8;
-                }
-                
-                part_info = detect_color(img, new_image, c, x_m, y_m);
-                part_info.push_back(quadrant);
-                right_bin_info.push_back(part_info);
-            }
-        }
-        i++;
-    }
-    return right_bin_info;
-}
+    cv::Mat new_image;
+    cv::bitwise_and(img_conv, img_conv, new_image, mask);
 
-std::vector<std::vector<int>> leftbin(cv::Mat img){
-    std::vector<std::vector<int>> left_bin_info;
-    std::vector<int> part_info;
-
-    cv::Mat img_bin_tr = img(cv::Range(28,223), cv::Range(356,548));
-    cv::Mat img_bin_tl = img(cv::Range(28,223), cv::Range(118,308));
-    cv::Mat img_bin_br = img(cv::Range(267,458), cv::Range(356,548));
-    cv::Mat img_bin_bl = img(cv::Range(267,458), cv::Range(118,308));
-
-    // std::vector<cv::Mat> image{img_bin_br, img_bin_bl, img_bin_tl, img_bin_tr}; // Old one
-    std::vector<cv::Mat> image{img_bin_bl, img_bin_br, img_bin_tr, img_bin_tl};  // After Tanmay's modification
-    int i = 0;
-
-    for (auto img : image) {
-
-        cv::Mat img_hsv;
-        cv::cvtColor(img.clone(), img_hsv, cv::COLOR_BGR2HSV);
-
-        cv::Scalar lower_red(0, 25, 25);
-        cv::Scalar upper_red(10, 255, 255);
-        cv::Scalar lower_red1(170, 25, 25);
-        cv::Scalar upper_red1(180, 255, 255);
-
-        cv::Scalar lower_green(36, 25, 25);
-        cv::Scalar upper_green(70, 255, 255);
-
-        cv::Scalar lower_blue(110, 25, 25);
-        cv::Scalar upper_blue(130, 255, 255);
-
-        cv::Scalar lower_orange(6, 25, 25);
-        cv::Scalar upper_orange(26, 255, 255);
-
-        cv::Scalar lower_purple(128, 25, 25);
-        cv::Scalar upper_purple(148, 255, 255);
-
-        cv::Scalar lower_gray(0, 0, 32);
-        cv::Scalar upper_gray(0, 255, 117);
-        
-        cv::Mat mask1, mask11;
-        cv::inRange(img_hsv, lower_red, upper_red, mask1);
-        cv::inRange(img_hsv, lower_red1, upper_red1, mask11);
-        
-        cv::Mat mask2;
-        cv::inRange(img_hsv, lower_green, upper_green, mask2);
-        
-        cv::Mat mask3;
-        cv::inRange(img_hsv, lower_blue, upper_blue, mask3);
-
-        cv::Mat mask4;
-        cv::inRange(img_hsv, lower_orange, upper_orange, mask4);
-
-        cv::Mat mask5;
-        cv::inRange(img_hsv, lower_purple, upper_purple, mask5);
-        
-        cv::Mat mask6;
-        cv::inRange(img_hsv, lower_gray, upper_gray, mask6);
-
-        cv::Mat mask = mask1 + mask11 + mask2 + mask3 + mask4 + mask5 + mask6;
-        
-        cv::Mat element = cv::Mat::ones(3, 3, CV_8U);
-        
-        // cv::morphologyEx(mask, mask, cv::MORPH_OPEN, element, cv::Point(-1,-1), 2);
-        cv::erode(mask, mask, element, cv::Point(-1, -1));
-        cv::erode(mask, mask, element, cv::Point(-1, -1));
-        cv::dilate(mask, mask, element, cv::Point(-1, -1));
-        cv::dilate(mask, mask, element, cv::Point(-1, -1));
-
-        // cv::morphologyEx(mask, mask, cv::MORPH_CLOSE, element, cv::Point(-1,-1), 1);
-        cv::dilate(mask, mask, element, cv::Point(-1, -1));
-        cv::erode(mask, mask, element, cv::Point(-1, -1));
-        
-        cv::Mat new_image;
-        cv::bitwise_and(img, img, new_image, mask);
-        
-        cv::Mat blur;
-        cv::GaussianBlur(mask, blur, cv::Size(5, 5), 0);
-        
-        std::vector<std::vector<cv::Point>> contours;
-        std::vector<cv::Vec4i> hierarchy;
-        cv::findContours(blur, contours, hierarchy, cv::RETR_TREE, cv::CHAIN_APPROX_SIMPLE);
-        
-        int x_m;
-        int y_m;
-        int quadrant;
-
-        for (auto c : contours) {
-            auto area_cnt = cv::contourArea(c);
-            cv::Moments M = cv::moments(c);
-            if (M.m00 != 0.0) { 
-                cv::Point p(M.m10/M.m00, M.m01/M.m00);
-                x_m = int(p.x);
-                y_m = int(p.y);
-            }
-
-            if (area_cnt > 500 && area_cnt < 3000) {
-                if ((137<=x_m && x_m<=195) &&  (130<=y_m && y_m<=192)){
-                    quadrant =  9*i + 45;
-                }
-                else if ((0<=x_m && x_m<=70) &&  (0<=y_m && y_m<=65)){
-                    quadrant =  9*i + 37;
-                }
-                else if ((71<=x_m && x_m<=135) &&  (0<=y_m && y_m<=65)){
-                    quadrant =  9*i + 38;
-                }
-                else if ((137<=x_m && x_m<=195) &&  (0<=y_m && y_m<=65)){
-                    quadrant =  9*i + 39;
-                }
-                else if ((0<=x_m && x_m<=70) &&  (69<=y_m && y_m<=126)){
-                    quadrant =  9*i + 40;
-                }
-                else if ((71<=x_m && x_m<=135) &&  (69<=y_m && y_m<=126)){
-                    quadrant =  9*i + 41;
-                }
-                else if ((137<=x_m && x_m<=195) &&  (69<=y_m && y_m<=126)){
-                    quadrant =  9*i + 42;
-                }
-                else if ((0<=x_m && x_m<=70) &&  (130<=y_m && y_m<=192)){
-                    quadrant =  9*i + 43;
-                }
-                else if ((71<=x_m && x_m<=135) &&  (130<=y_m && y_m<=192)){
-                    quadrant =  9*i + 44;
-                }
-                
-                part_info = detect_color(img, new_image, c, x_m, y_m);
-                part_info.push_back(quadrant);
-                
-                left_bin_info.push_back(part_info);
-
-            }
+    cv::Mat blur;
+    cv::GaussianBlur(mask, blur, cv::Size(5, 5), 0);
+
+    std::vector<std::vector<cv::Point>> contours;
+    std::vector<cv::Vec4i> hierarchy;
+    cv::findContours(blur, contours, hierarchy, cv::RETR_TREE, cv::CHAIN_APPROX_SIMPLE);
+
+    for (auto c : contours) {
+        cv::Moments M = cv::moments(c);
+        if (M.m00 == 0.0) {
+            continue;
+        }
+        int x_m = int(M.m10/M.m00);
+        int y_m = int(M.m01/M.m00);
+
+        cv::Vec3b hsv = img_hsv.at<cv::Vec3b>(y_m, x_m);
+        int part_clr;
+        if (hsv[0]>10 && hsv[0]<25) {
+            part_clr = ariac_msgs::msg::Part::ORANGE;  // 3 - Orange
+        } else if(hsv[0]>=130 && hsv[0]<170) {
+            part_clr = ariac_msgs::msg::Part::PURPLE;  // 4 - Purple
+        } else if (hsv[0]>=90 && hsv[0]<130) {
+            part_clr = ariac_msgs::msg::Part::BLUE;  // 2 - Blue
+        } else if (hsv[0]<=10) {
+            part_clr = ariac_msgs::msg::Part::RED;  // 0 - Red
+        } else if (hsv[0]>36 && hsv[0]<89) {
+            part_clr = ariac_msgs::msg::Part::GREEN;  // 1 - Green
+        } else {
+            continue;
         }
-        i++;
+        int part_type = conveyor_detect_type(new_image.clone(), c);
+        conveyor_info.push_back({part_clr, part_type, 0});
     }
-    return left_bin_info;
+    return conveyor_info;
 }
 
 // int main(){
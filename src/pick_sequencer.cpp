@@ -0,0 +1,225 @@
+/**
+ * @copyright Copyright (c) 2023
+ * @file pick_sequencer.cpp
+ * @author Sanchit Kedia (sanchit@terpmail.umd.edu)
+ * @author Adarsh Malapaka (amalapak@terpmail.umd.edu)
+ * @author Tanmay Haldankar (tanmayh@terpmail.umd.edu)
+ * @author Sahruday Patti (sahruday@umd.edu)
+ * @author Kshitij Karnawat (kshitij@umd.edu)
+ * @brief Implementation of the kit pick sequencing for ARIAC 2023 (Group 3)
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ *
+ */
+#include "pick_sequencer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+constexpr int kClasses = 4;  // Right/left bins x floor/ceiling robot
+
+using ClassSlots = std::array<SlotMask, kClasses>;
+
+int slot_class(int slot, const SlotMask& floor_reachable) {
+    return (slot < BinSlotTable::kSlots / 2 ? 0 : 1) + (floor_reachable.test(slot) ? 0 : 2);
+}
+
+struct Search {
+    explicit Search(const PickTravelModel& model) : model(model) {}
+
+    const PickTravelModel& model;
+    std::vector<int> pending;        // Kit part indices to plan
+    std::vector<ClassSlots> slots;   // Candidate slots of each pending part by class
+    std::vector<PickStep> current;
+    std::vector<PickStep> best;
+    SlotMask used;
+    double best_seconds = std::numeric_limits<double>::infinity();
+};
+
+/**
+ * @brief Branch and bound over the order of the pending parts and the class each one picks from
+ *
+ * A part with no free slot left in any class is recorded as missing at no cost.
+ */
+void search_exact(Search& s, unsigned remaining, double rail, double gantry, double seconds) {
+    if (seconds >= s.best_seconds) {
+        return;
+    }
+    if (remaining == 0) {
+        s.best_seconds = seconds;
+        s.best = s.current;
+        return;
+    }
+    for (size_t i = 0; i < s.pending.size(); i++) {
+        if (!(remaining & (1u << i))) {
+            continue;
+        }
+        bool found = false;
+        for (int c = 0; c < kClasses; c++) {
+            int slot = s.slots[i][c].without(s.used).first();
+            if (slot == -1) {
+                continue;
+            }
+            found = true;
+            double r = rail;
+            double g = gantry;
+            double t = s.model.pick(slot, r, g);
+            s.used.set(slot);
+            s.current.push_back({s.pending[i], slot + 1});
+            search_exact(s, remaining & ~(1u << i), r, g, seconds + t);
+            s.current.pop_back();
+            s.used.reset(slot);
+        }
+        if (!found) {
+            s.current.push_back({s.pending[i], -1});
+            search_exact(s, remaining & ~(1u << i), rail, gantry, seconds);
+            s.current.pop_back();
+        }
+    }
+}
+
+/**
+ * @brief Take the cheapest next pick until every pending part is placed
+ *
+ */
+void search_greedy(Search& s, double rail, double gantry) {
+    std::vector<bool> placed(s.pending.size(), false);
+    s.best_seconds = 0.0;
+    for (size_t step = 0; step < s.pending.size(); step++) {
+        int best_part = -1;
+        int best_slot = -1;
+        double best_t = 0.0;
+        for (size_t i = 0; i < s.pending.size(); i++) {
+            if (placed[i]) {
+                continue;
+            }
+            for (int c = 0; c < kClasses; c++) {
+                int slot = s.slots[i][c].without(s.used).first();
+                if (slot == -1) {
+                    continue;
+                }
+                double r = rail;
+                double g = gantry;
+                double t = s.model.pick(slot, r, g);
+                if (best_slot == -1 || t < best_t) {
+                    best_part = static_cast<int>(i);
+                    best_slot = slot;
+                    best_t = t;
+                }
+            }
+        }
+        if (best_slot == -1) {
+            break;
+        }
+        placed[best_part] = true;
+        s.used.set(best_slot);
+        s.model.pick(best_slot, rail, gantry);
+        s.best_seconds += best_t;
+        s.best.push_back({s.pending[best_part], best_slot + 1});
+    }
+    for (size_t i = 0; i < s.pending.size(); i++) {
+        if (!placed[i]) {
+            s.best.push_back({s.pending[i], -1});
+        }
+    }
+}
+
+}  // namespace
+
+double PickTravelModel::pick(int slot, double& rail, double& gantry) const {
+    bool right = slot < BinSlotTable::kSlots / 2;
+    if (floor_reachable.test(slot)) {
+        double bins = right ? right_bins_rail : left_bins_rail;
+        double seconds = (std::abs(rail - bins) + std::abs(bins - agv_rail)) / rail_speed;
+        rail = agv_rail;
+        return seconds;
+    }
+    double bins = right ? right_bins_gantry : left_bins_gantry;
+    double seconds = (std::abs(gantry - bins) + std::abs(bins - agv_gantry)) / gantry_speed + ceiling_overhead;
+    gantry = agv_gantry;
+    return seconds;
+}
+
+const PickPlan& PickSequencer::plan(const std::string& order_id, const std::vector<int>& parts, size_t done,
+                                    const BinSlotTable& bins, const SlotMask& excluded, const PickTravelModel& model) {
+    auto it = plans_.find(order_id);
+    if (it != plans_.end() && valid(it->second, parts, done, bins, excluded)) {
+        return it->second;
+    }
+
+    // Keep the steps already done, a plan made after some parts were picked assumes kit order
+    std::vector<PickStep> kept;
+    if (it != plans_.end()) {
+        kept.assign(it->second.steps.begin(), it->second.steps.begin() + std::min(done, it->second.steps.size()));
+    }
+    for (size_t i = kept.size(); i < std::min(done, parts.size()); i++) {
+        kept.push_back({static_cast<int>(i), -1});
+    }
+    std::vector<bool> kept_part(parts.size(), false);
+    for (const PickStep& step : kept) {
+        kept_part[step.part] = true;
+    }
+
+    Search s(model);
+    for (size_t i = 0; i < parts.size(); i++) {
+        if (kept_part[i]) {
+            continue;
+        }
+        ClassSlots slots;
+        int index = BinSlotTable::part_index(parts[i]);
+        if (index != -1) {
+            bins.by_part[index].without(excluded).for_each([&](int slot) {
+                slots[slot_class(slot, model.floor_reachable)].set(slot);
+            });
+        }
+        s.pending.push_back(static_cast<int>(i));
+        s.slots.push_back(slots);
+    }
+    if (s.pending.size() <= kMaxExact) {
+        search_exact(s, (1u << s.pending.size()) - 1, model.rail_position, model.gantry_position, 0.0);
+    } else {
+        search_greedy(s, model.rail_position, model.gantry_position);
+    }
+
+    // Missing parts go last, they fall back to other kit trays after every bin pick
+    std::stable_partition(s.best.begin(), s.best.end(), [](const PickStep& step) { return step.quadrant != -1; });
+
+    PickPlan& plan = plans_[order_id];
+    plan.steps = kept;
+    plan.steps.insert(plan.steps.end(), s.best.begin(), s.best.end());
+    plan.seconds = s.best_seconds;
+    return plan;
+}
+
+bool PickSequencer::valid(const PickPlan& plan, const std::vector<int>& parts, size_t done,
+                          const BinSlotTable& bins, const SlotMask& excluded) const {
+    if (plan.steps.size() != parts.size() || done > plan.steps.size()) {
+        return false;
+    }
+    SlotMask planned;
+    for (size_t i = done; i < plan.steps.size(); i++) {
+        const PickStep& step = plan.steps[i];
+        if (step.quadrant == -1) {
+            continue;
+        }
+        int slot = step.quadrant - 1;
+        if (!bins.occupied.test(slot) || bins.part[slot] != parts[step.part] || excluded.test(slot)) {
+            return false;
+        }
+        planned.set(slot);
+    }
+    // A part planned as missing may have turned up since
+    for (size_t i = done; i < plan.steps.size(); i++) {
+        const PickStep& step = plan.steps[i];
+        int index = BinSlotTable::part_index(parts[step.part]);
+        if (step.quadrant == -1 && index != -1 && bins.by_part[index].without(excluded).without(planned).any()) {
+            return false;
+        }
+    }
+    return true;
+}
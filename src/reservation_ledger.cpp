@@ -0,0 +1,216 @@
+/**
+ * @copyright Copyright (c) 2023
+ * @file reservation_ledger.cpp
+ * @author Sanchit Kedia (sanchit@terpmail.umd.edu)
+ * @author Adarsh Malapaka (amalapak@terpmail.umd.edu)
+ * @author Tanmay Haldankar (tanmayh@terpmail.umd.edu)
+ * @author Sahruday Patti (sahruday@umd.edu)
+ * @author Kshitij Karnawat (kshitij@umd.edu)
+ * @brief Implementation of the part reservation ledger for ARIAC 2023 (Group 3)
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ *
+ */
+#include "reservation_ledger.hpp"
+
+#include <algorithm>
+
+namespace {
+
+SlotMask bin_candidates(const BinSlotTable& bins, int part_type_clr) {
+    int index = BinSlotTable::part_index(part_type_clr);
+    return index == -1 ? SlotMask() : bins.by_part[index];
+}
+
+}  // namespace
+
+std::vector<int> ReservationLedger::reserve(const std::string& order_id, bool priority, const std::vector<int>& bill,
+                                            const BinSlotTable& bins, const std::vector<int>& conveyor_parts,
+                                            const std::vector<int>& kit_tray_parts) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto existing = orders_.find(order_id);
+    if (existing != orders_.end()) {
+        OrderEntry& order = existing->second;
+        std::vector<int> missing;
+        missing.swap(order.shortages);
+        for (int part : missing) {
+            if (!reserve_part(order_id, order, part, bins, conveyor_parts, kit_tray_parts)) {
+                order.shortages.push_back(part);
+            }
+        }
+        return order.shortages;
+    }
+
+    OrderEntry& order = orders_[order_id];
+    order.priority = priority;
+    for (int part : bill) {
+        if (!reserve_part(order_id, order, part, bins, conveyor_parts, kit_tray_parts)) {
+            order.shortages.push_back(part);
+        }
+    }
+    return order.shortages;
+}
+
+int ReservationLedger::retry(const BinSlotTable& bins, const std::vector<int>& conveyor_parts,
+                             const std::vector<int>& kit_tray_parts) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int reserved = 0;
+    // Priority orders first, they may also take back parts from the regular orders
+    for (bool priority : {true, false}) {
+        for (auto& entry : orders_) {
+            OrderEntry& order = entry.second;
+            if (order.priority != priority || order.shortages.empty()) {
+                continue;
+            }
+            std::vector<int> missing;
+            missing.swap(order.shortages);
+            for (int part : missing) {
+                if (reserve_part(entry.first, order, part, bins, conveyor_parts, kit_tray_parts)) {
+                    reserved++;
+                } else {
+                    order.shortages.push_back(part);
+                }
+            }
+        }
+    }
+    return reserved;
+}
+
+bool ReservationLedger::conveyor_part_placed(int part_type_clr, int quadrant) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (quadrant < 1 || quadrant > BinSlotTable::kSlots) {
+        return false;
+    }
+    for (bool priority : {true, false}) {
+        for (auto& entry : orders_) {
+            if (entry.second.priority != priority) {
+                continue;
+            }
+            for (auto& r : entry.second.reservations) {
+                if (r.source == Source::kConveyor && r.part_type_clr == part_type_clr) {
+                    r.source = Source::kBin;
+                    r.quadrant = quadrant;
+                    reserved_.set(quadrant - 1);
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+void ReservationLedger::release(const std::string& order_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = orders_.find(order_id);
+    if (it == orders_.end()) {
+        return;
+    }
+    for (const auto& r : it->second.reservations) {
+        if (r.source == Source::kBin) {
+            unreserve(r.quadrant);
+        }
+    }
+    orders_.erase(it);
+}
+
+SlotMask ReservationLedger::blocked_for(const std::string& order_id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto self = orders_.find(order_id);
+    bool priority = self != orders_.end() && self->second.priority;
+    SlotMask blocked;
+    for (const auto& order : orders_) {
+        if (order.first == order_id || (priority && !order.second.priority)) {
+            continue;
+        }
+        for (const auto& r : order.second.reservations) {
+            if (r.source == Source::kBin) {
+                blocked.set(r.quadrant - 1);
+            }
+        }
+    }
+    return blocked;
+}
+
+void ReservationLedger::consume(const std::string& order_id, int part_type_clr, Source source, int quadrant) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = orders_.find(order_id);
+    if (it == orders_.end()) {
+        return;
+    }
+    auto& reservations = it->second.reservations;
+    auto match = std::find_if(reservations.begin(), reservations.end(), [&](const Reservation& r) {
+        return r.part_type_clr == part_type_clr && r.source == source && r.quadrant == quadrant;
+    });
+    if (match == reservations.end()) {
+        match = std::find_if(reservations.begin(), reservations.end(), [&](const Reservation& r) {
+            return r.part_type_clr == part_type_clr && r.source == source;
+        });
+    }
+    if (match == reservations.end()) {
+        return;
+    }
+    if (match->source == Source::kBin) {
+        unreserve(match->quadrant);
+    }
+    reservations.erase(match);
+}
+
+std::vector<int> ReservationLedger::shortages(const std::string& order_id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = orders_.find(order_id);
+    return it == orders_.end() ? std::vector<int>() : it->second.shortages;
+}
+
+int ReservationLedger::reserved_count(int part_type_clr, Source source) const {
+    int count = 0;
+    for (const auto& order : orders_) {
+        for (const auto& r : order.second.reservations) {
+            count += (r.part_type_clr == part_type_clr && r.source == source) ? 1 : 0;
+        }
+    }
+    return count;
+}
+
+bool ReservationLedger::reserve_part(const std::string& order_id, OrderEntry& order, int part_type_clr,
+                                     const BinSlotTable& bins, const std::vector<int>& conveyor_parts,
+                                     const std::vector<int>& kit_tray_parts) {
+    int slot = bin_candidates(bins, part_type_clr).without(reserved_).first();
+    int quadrant = slot == -1 ? -1 : slot + 1;
+    if (quadrant != -1 || (order.priority && steal_bin(order_id, part_type_clr, bins, quadrant))) {
+        reserved_.set(quadrant - 1);
+        order.reservations.push_back({part_type_clr, Source::kBin, quadrant});
+    } else if (std::count(conveyor_parts.begin(), conveyor_parts.end(), part_type_clr) > reserved_count(part_type_clr, Source::kConveyor)) {
+        order.reservations.push_back({part_type_clr, Source::kConveyor, -1});
+    } else if (std::count(kit_tray_parts.begin(), kit_tray_parts.end(), part_type_clr) > reserved_count(part_type_clr, Source::kKitTray)) {
+        order.reservations.push_back({part_type_clr, Source::kKitTray, -1});
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool ReservationLedger::steal_bin(const std::string& order_id, int part_type_clr, const BinSlotTable& bins, int& quadrant) {
+    SlotMask available = bin_candidates(bins, part_type_clr);
+    for (auto& order : orders_) {
+        if (order.first == order_id || order.second.priority) {
+            continue;
+        }
+        auto& reservations = order.second.reservations;
+        for (auto r = reservations.begin(); r != reservations.end(); ++r) {
+            if (r->source == Source::kBin && r->part_type_clr == part_type_clr && available.test(r->quadrant - 1)) {
+                quadrant = r->quadrant;
+                order.second.shortages.push_back(part_type_clr);
+                reservations.erase(r);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void ReservationLedger::unreserve(int quadrant) {
+    if (quadrant >= 1 && quadrant <= BinSlotTable::kSlots) {
+        reserved_.reset(quadrant - 1);
+    }
+}
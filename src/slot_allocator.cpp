@@ -0,0 +1,62 @@
+/**
+ * @copyright Copyright (c) 2023
+ * @file slot_allocator.cpp
+ * @author Sanchit Kedia (sanchit@terpmail.umd.edu)
+ * @author Adarsh Malapaka (amalapak@terpmail.umd.edu)
+ * @author Tanmay Haldankar (tanmayh@terpmail.umd.edu)
+ * @author Sahruday Patti (sahruday@umd.edu)
+ * @author Kshitij Karnawat (kshitij@umd.edu)
+ * @brief Implementation of the free bin slot allocator for ARIAC 2023 (Group 3)
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ *
+ */
+#include "slot_allocator.hpp"
+
+SlotAllocator::SlotAllocator() {
+    // Until told otherwise every slot counts as floor reachable
+    for (int slot = 0; slot < BinSlotTable::kSlots; slot++) {
+        floor_reachable_.set(slot);
+        free_[side_of(slot)][true].set(slot);
+    }
+}
+
+void SlotAllocator::set_floor_reachable(const SlotMask& floor_reachable) {
+    floor_reachable_ = floor_reachable;
+    for (int side = 0; side < 2; side++) {
+        SlotMask side_free = free_[side][false] | free_[side][true];
+        free_[side][true] = side_free & floor_reachable;
+        free_[side][false] = SlotMask();
+        side_free.for_each([&](int slot) {
+            if (!floor_reachable.test(slot)) {
+                free_[side][false].set(slot);
+            }
+        });
+    }
+}
+
+int SlotAllocator::acquire(int preferred_side) {
+    int slot = free_[preferred_side][true].first();
+    if (slot == -1) {
+        slot = free_[1 - preferred_side][true].first();
+    }
+    if (slot != -1) {
+        occupy(slot);
+    }
+    return slot;
+}
+
+void SlotAllocator::occupy(int slot) {
+    if (slot < 0 || slot >= BinSlotTable::kSlots) {
+        return;
+    }
+    free_[side_of(slot)][floor_reachable_.test(slot)].reset(slot);
+}
+
+void SlotAllocator::release(int slot) {
+    if (slot < 0 || slot >= BinSlotTable::kSlots) {
+        return;
+    }
+    free_[side_of(slot)][floor_reachable_.test(slot)].set(slot);
+}
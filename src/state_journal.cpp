@@ -0,0 +1,452 @@
+/**
+ * @copyright Copyright (c) 2023
+ * @file state_journal.cpp
+ * @author Sanchit Kedia (sanchit@terpmail.umd.edu)
+ * @author Adarsh Malapaka (amalapak@terpmail.umd.edu)
+ * @author Tanmay Haldankar (tanmayh@terpmail.umd.edu)
+ * @author Sahruday Patti (sahruday@umd.edu)
+ * @author Kshitij Karnawat (kshitij@umd.edu)
+ * @brief Implementation of the memory mapped workcell state journal for ARIAC 2023 (Group 3)
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ *
+ */
+#include "state_journal.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+constexpr char kMagic[8] = {'G', '3', 'J', 'R', 'N', 'L', '\0', '\0'};
+constexpr uint32_t kVersion = 2;
+
+static_assert(sizeof(StateJournal::Record) == 72, "Journal records are 72 bytes on disk");
+static_assert(sizeof(StateJournal::Record::data) == sizeof(StateJournal::Record::pose), "Order data fills the pose");
+
+StateJournal::Record make_record(uint16_t type, int32_t a = 0, int32_t b = 0, int32_t c = 0) {
+    StateJournal::Record record;
+    std::memset(&record, 0, sizeof(record));
+    record.type = type;
+    record.a = a;
+    record.b = b;
+    record.c = c;
+    record.time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    return record;
+}
+
+void set_order_id(StateJournal::Record& record, const std::string& order_id) {
+    std::strncpy(record.order_id, order_id.c_str(), sizeof(record.order_id) - 1);
+}
+
+std::string get_order_id(const StateJournal::Record& record) {
+    return std::string(record.order_id, strnlen(record.order_id, sizeof(record.order_id)));
+}
+
+void set_pose(StateJournal::Record& record, const geometry_msgs::msg::Pose& pose) {
+    record.pose[0] = static_cast<float>(pose.position.x);
+    record.pose[1] = static_cast<float>(pose.position.y);
+    record.pose[2] = static_cast<float>(pose.position.z);
+    record.pose[3] = static_cast<float>(pose.orientation.x);
+    record.pose[4] = static_cast<float>(pose.orientation.y);
+    record.pose[5] = static_cast<float>(pose.orientation.z);
+    record.pose[6] = static_cast<float>(pose.orientation.w);
+}
+
+geometry_msgs::msg::Pose get_pose(const StateJournal::Record& record) {
+    geometry_msgs::msg::Pose pose;
+    pose.position.x = record.pose[0];
+    pose.position.y = record.pose[1];
+    pose.position.z = record.pose[2];
+    pose.orientation.x = record.pose[3];
+    pose.orientation.y = record.pose[4];
+    pose.orientation.z = record.pose[5];
+    pose.orientation.w = record.pose[6];
+    return pose;
+}
+
+size_t file_size(size_t capacity) {
+    return 64 + capacity * sizeof(StateJournal::Record);
+}
+
+}  // namespace
+
+StateJournal::~StateJournal() {
+    unmap();
+}
+
+bool StateJournal::open(const std::string& path, size_t capacity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    unmap();
+    path_ = path;
+    state_ = State();
+    count_ = 0;
+    if (!map(path, capacity)) {
+        return false;
+    }
+    // Replay up to the first empty or torn record
+    while (count_ < capacity_ && records_[count_].type != 0 && records_[count_].checksum == checksum(records_[count_])) {
+        apply(records_[count_], state_);
+        count_++;
+    }
+    // Zero what a crash may have left after the last valid record
+    if (count_ < capacity_) {
+        std::memset(&records_[count_], 0, sizeof(Record));
+    }
+    compacted_count_ = count_;
+    compacted_at_ = std::chrono::steady_clock::now();
+    return true;
+}
+
+void StateJournal::set_compaction(size_t records, std::chrono::seconds interval) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    compact_records_ = records;
+    compact_interval_ = interval;
+}
+
+int64_t StateJournal::competition_start() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return competition_start_ns_;
+}
+
+bool StateJournal::start(int64_t competition_start_ns) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    state_ = State();
+    competition_start_ns_ = competition_start_ns;
+    return records_ && compact_locked();
+}
+
+void StateJournal::order_accepted(const std::string& order_id, int type, bool priority, const std::string& message) {
+    Record record = make_record(kOrderAccepted, type, priority ? 1 : 0, static_cast<int32_t>(message.size()));
+    set_order_id(record, order_id);
+    append(record);
+
+    std::vector<Record> records;
+    order_records({order_id, type, priority, message.size(), message}, 0, records);
+    for (const auto& data : records) {
+        append(data);
+    }
+}
+
+void StateJournal::order_submitted(const std::string& order_id) {
+    Record record = make_record(kOrderSubmitted);
+    set_order_id(record, order_id);
+    append(record);
+}
+
+void StateJournal::slot_changed(int quadrant, int part_type_clr) {
+    append(make_record(kSlotChanged, quadrant, part_type_clr));
+}
+
+void StateJournal::agv_moved(int agv, int destination) {
+    append(make_record(kAgvMoved, agv, destination));
+}
+
+void StateJournal::part_placed(int agv, int quadrant, int part_type_clr, const std::string& order_id,
+                               const geometry_msgs::msg::Pose& pose) {
+    Record record = make_record(kPartPlaced, agv, quadrant, part_type_clr);
+    set_order_id(record, order_id);
+    set_pose(record, pose);
+    append(record);
+}
+
+void StateJournal::part_removed(int agv, int quadrant) {
+    append(make_record(kPartRemoved, agv, quadrant));
+}
+
+void StateJournal::kit_tray_cleared(int agv) {
+    append(make_record(kKitTrayCleared, agv));
+}
+
+void StateJournal::conveyor_announced(int announced, const std::vector<int>& parts) {
+    append(make_record(kConveyorAnnounced, announced));
+    for (size_t i = 0; i < parts.size(); i++) {
+        append(make_record(kConveyorPart, static_cast<int32_t>(i), parts[i]));
+    }
+}
+
+void StateJournal::conveyor_part_passed(int parts_left) {
+    append(make_record(kConveyorPartPassed, parts_left));
+}
+
+void StateJournal::slot_allocated(int quadrant) {
+    append(make_record(kSlotAllocated, quadrant));
+}
+
+StateJournal::State StateJournal::state() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return state_;
+}
+
+bool StateJournal::compact() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return compact_locked();
+}
+
+size_t StateJournal::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return count_;
+}
+
+uint32_t StateJournal::checksum(const Record& record) {
+    const auto* bytes = reinterpret_cast<const unsigned char*>(&record);
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < offsetof(Record, checksum); i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+void StateJournal::apply(const Record& record, State& state) {
+    switch (record.type) {
+        case kOrderAccepted: {
+            std::string id = get_order_id(record);
+            auto it = std::find_if(state.orders.begin(), state.orders.end(), [&](const OrderEntry& o) { return o.id == id; });
+            if (it == state.orders.end()) {
+                state.orders.push_back({id, record.a, record.b != 0, static_cast<size_t>(std::max(record.c, 0)), std::string()});
+            }
+            break;
+        }
+        case kOrderData: {
+            std::string id = get_order_id(record);
+            auto it = std::find_if(state.orders.begin(), state.orders.end(), [&](const OrderEntry& o) { return o.id == id; });
+            // Chunks are appended in order, anything else belongs to an order accepted twice
+            if (it != state.orders.end() && static_cast<size_t>(record.a) == it->message.size() &&
+                record.c > 0 && record.c <= static_cast<int32_t>(sizeof(record.data)) &&
+                it->message.size() + record.c <= it->size) {
+                it->message.append(record.data, record.c);
+            }
+            break;
+        }
+        case kOrderSubmitted: {
+            std::string id = get_order_id(record);
+            state.orders.erase(std::remove_if(state.orders.begin(), state.orders.end(),
+                                              [&](const OrderEntry& o) { return o.id == id; }),
+                               state.orders.end());
+            break;
+        }
+        case kSlotChanged:
+            if (record.a >= 1 && record.a <= static_cast<int>(state.slots.size())) {
+                state.slots[record.a - 1] = record.b;
+            }
+            // The dropped part was seen or the slot was reused, it is tracked as a bin part from now on
+            state.allocated_slots.erase(record.a);
+            break;
+        case kSlotAllocated:
+            state.allocated_slots.insert(record.a);
+            break;
+        case kConveyorAnnounced:
+            state.conveyor_announced = true;
+            state.conveyor_size = record.a;
+            state.conveyor_parts.clear();
+            break;
+        case kConveyorPart:
+            if (static_cast<size_t>(record.a) == state.conveyor_parts.size()) {
+                state.conveyor_parts.push_back(record.b);
+            }
+            break;
+        case kConveyorPartPassed:
+            if (record.a >= 0 && static_cast<size_t>(record.a) < state.conveyor_parts.size()) {
+                state.conveyor_parts.resize(record.a);
+            }
+            break;
+        case kAgvMoved:
+            state.agv_destinations[record.a] = record.b;
+            break;
+        case kPartPlaced:
+            state.kit_tray_parts[{record.a, record.b}] = {record.c, get_order_id(record), get_pose(record)};
+            break;
+        case kPartRemoved:
+            state.kit_tray_parts.erase({record.a, record.b});
+            break;
+        case kKitTrayCleared:
+            state.kit_tray_parts.erase(state.kit_tray_parts.lower_bound({record.a, 0}),
+                                       state.kit_tray_parts.lower_bound({record.a + 1, 0}));
+            break;
+        default:
+            break;
+    }
+}
+
+std::vector<StateJournal::Record> StateJournal::snapshot_records(const State& state) {
+    std::vector<Record> records;
+    for (const auto& order : state.orders) {
+        Record record = make_record(kOrderAccepted, order.type, order.priority ? 1 : 0, static_cast<int32_t>(order.size));
+        set_order_id(record, order.id);
+        records.push_back(record);
+        order_records(order, 0, records);
+    }
+    for (size_t slot = 0; slot < state.slots.size(); slot++) {
+        if (state.slots[slot] != -1) {
+            records.push_back(make_record(kSlotChanged, static_cast<int32_t>(slot + 1), state.slots[slot]));
+        }
+    }
+    for (const auto& agv : state.agv_destinations) {
+        records.push_back(make_record(kAgvMoved, agv.first, agv.second));
+    }
+    for (const auto& part : state.kit_tray_parts) {
+        Record record = make_record(kPartPlaced, part.first.first, part.first.second, part.second.part_type_clr);
+        set_order_id(record, part.second.order_id);
+        set_pose(record, part.second.pose);
+        records.push_back(record);
+    }
+    if (state.conveyor_announced) {
+        records.push_back(make_record(kConveyorAnnounced, state.conveyor_size));
+        for (size_t i = 0; i < state.conveyor_parts.size(); i++) {
+            records.push_back(make_record(kConveyorPart, static_cast<int32_t>(i), state.conveyor_parts[i]));
+        }
+    }
+    for (int quadrant : state.allocated_slots) {
+        records.push_back(make_record(kSlotAllocated, quadrant));
+    }
+    for (auto& record : records) {
+        record.checksum = checksum(record);
+    }
+    return records;
+}
+
+void StateJournal::order_records(const OrderEntry& order, size_t offset, std::vector<Record>& records) {
+    for (size_t i = offset; i < order.message.size(); i += sizeof(Record::data)) {
+        size_t bytes = std::min(sizeof(Record::data), order.message.size() - i);
+        Record record = make_record(kOrderData, static_cast<int32_t>(i), 0, static_cast<int32_t>(bytes));
+        set_order_id(record, order.id);
+        std::memcpy(record.data, order.message.data() + i, bytes);
+        records.push_back(record);
+    }
+}
+
+void StateJournal::append(Record record) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    apply(record, state_);
+    if (!records_) {
+        return;
+    }
+    bool due = count_ == capacity_ || count_ - compacted_count_ >= compact_records_ ||
+               (count_ > compacted_count_ && std::chrono::steady_clock::now() - compacted_at_ >= compact_interval_);
+    // A failed compaction is retried later, the record still goes in while there is room
+    if (due && !compact_locked() && (!records_ || count_ == capacity_)) {
+        return;
+    }
+    record.checksum = 0;
+    Record& slot = records_[count_];
+    std::memcpy(&slot, &record, offsetof(Record, checksum));
+    // The checksum is written last, a record without it is dropped on replay
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.checksum = checksum(slot);
+    count_++;
+}
+
+bool StateJournal::map(const std::string& path, size_t capacity) {
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd_ < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd_, &st) != 0) {
+        unmap();
+        return false;
+    }
+    bool fresh = st.st_size < static_cast<off_t>(sizeof(Header));
+    if (!fresh) {
+        // Keep the capacity of an existing journal if it is larger, discard one of another format
+        Header header;
+        if (pread(fd_, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) ||
+            std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion ||
+            header.record_size != sizeof(Record)) {
+            if (ftruncate(fd_, 0) != 0) {
+                unmap();
+                return false;
+            }
+            fresh = true;
+            st.st_size = 0;
+        } else {
+            capacity = std::max<size_t>(capacity, header.capacity);
+        }
+    }
+    if (static_cast<size_t>(st.st_size) < file_size(capacity) && ftruncate(fd_, file_size(capacity)) != 0) {
+        unmap();
+        return false;
+    }
+    void* base = mmap(nullptr, file_size(capacity), PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (base == MAP_FAILED) {
+        unmap();
+        return false;
+    }
+    header_ = static_cast<Header*>(base);
+    records_ = reinterpret_cast<Record*>(static_cast<char*>(base) + sizeof(Header));
+    capacity_ = capacity;
+    if (fresh) {
+        std::memset(header_, 0, sizeof(Header));
+        std::memcpy(header_->magic, kMagic, sizeof(kMagic));
+        header_->version = kVersion;
+        header_->record_size = sizeof(Record);
+    }
+    header_->capacity = capacity;
+    competition_start_ns_ = header_->competition_start_ns;
+    return true;
+}
+
+void StateJournal::unmap() {
+    if (header_) {
+        munmap(header_, file_size(capacity_));
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+    fd_ = -1;
+    header_ = nullptr;
+    records_ = nullptr;
+    capacity_ = 0;
+}
+
+bool StateJournal::compact_locked() {
+    compacted_count_ = count_;
+    compacted_at_ = std::chrono::steady_clock::now();
+    std::vector<Record> records = snapshot_records(state_);
+    size_t capacity = capacity_;
+    while (records.size() * 2 > capacity) {
+        capacity *= 2;
+    }
+
+    // Write the snapshot to a new file and move it over the journal
+    std::string tmp_path = path_ + ".tmp";
+    int fd = ::open(tmp_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.record_size = sizeof(Record);
+    header.capacity = capacity;
+    header.competition_start_ns = competition_start_ns_;
+    bool ok = ftruncate(fd, file_size(capacity)) == 0 &&
+              pwrite(fd, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header)) &&
+              (records.empty() || pwrite(fd, records.data(), records.size() * sizeof(Record), sizeof(Header)) ==
+                                      static_cast<ssize_t>(records.size() * sizeof(Record))) &&
+              fsync(fd) == 0;
+    ::close(fd);
+    if (!ok || std::rename(tmp_path.c_str(), path_.c_str()) != 0) {
+        std::remove(tmp_path.c_str());
+        return false;
+    }
+
+    unmap();
+    if (!map(path_, capacity)) {
+        return false;
+    }
+    count_ = records.size();
+    compacted_count_ = count_;
+    return true;
+}
@@ -14,58 +14,64 @@
  */
 #include "tray_id_detect.hpp"
 
-std::vector<int> tray_detect(cv::Mat frame){
+#include <algorithm>
+
+namespace {
+
+// Tray marker windows in the kitting tray station camera image, one per tray slot
+const cv::Rect kTrayWindows[3] = {cv::Rect(167, 212, 31, 31),
+                                  cv::Rect(305, 212, 31, 31),
+                                  cv::Rect(443, 212, 32, 31)};
+
+// White border kept around each window so the markers keep their quiet zone
+constexpr int kStripPad = 16;
+constexpr int kStripCell = 32 + 2 * kStripPad;
+
+}  // namespace
+
+TrayDetector::TrayDetector()
+    : detector_(cv::aruco::getPredefinedDictionary(cv::aruco::DICT_4X4_250),
+                cv::aruco::DetectorParameters()),
+      strip_(31 + 2 * kStripPad, 3 * kStripCell, CV_8UC1, cv::Scalar(255)) {}
+
+std::vector<int> TrayDetector::detect(const cv::Mat& frame, int64_t stamp) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stamp >= 0 && stamp == cached_stamp_) {
+        return cached_ids_;
+    }
 
     std::vector<int> tray_aruco_id{-1, -1, -1};
+    if (frame.empty()) {
+        return tray_aruco_id;
+    }
+
+    for (int i = 0; i < 3; i++) {
+        const cv::Rect& window = kTrayWindows[i];
+        cv::Mat cell = strip_(cv::Rect(i * kStripCell + kStripPad, kStripPad, window.width, window.height));
+        cv::cvtColor(frame(window), cell, cv::COLOR_BGR2GRAY);
+    }
 
-    cv::Mat im = frame;
-    cv::Mat img = im.clone();
-    
-    cv::Mat blank_img(img.size().height, img.size().width, CV_8UC3, cv::Scalar(255, 255, 255));
-    blank_img(cv::Range(212,243), cv::Range(167,198)) = 0;
-    blank_img(cv::Range(212,243), cv::Range(305,336)) = 0;
-    blank_img(cv::Range(212,243), cv::Range(443,475)) = 0;
-    
-    cv::cvtColor(img, img, cv::COLOR_BGR2GRAY); 
-    cv::cvtColor(blank_img, blank_img, cv::COLOR_BGR2GRAY);
-    cv::add(img, blank_img, img);
-    
     std::vector<int> markerIDs;
     std::vector<std::vector<cv::Point2f>> corners, rejected;
-    
-    // For OpenCV 4.7.0
-    // cv::Ptr<cv::aruco::Dictionary> dictionary = cv::aruco::getPredefinedDictionary(cv::aruco::DICT_4X4_250);
-    // cv::aruco::detectMarkers(img, dictionary, corners, markerIDs);
-    
-    // For OpenCV 4.2.0
-    cv::aruco::DetectorParameters detectorParams = cv::aruco::DetectorParameters();
-    cv::aruco::Dictionary dictionary = cv::aruco::getPredefinedDictionary(cv::aruco::DICT_4X4_250);
-    cv::aruco::ArucoDetector detector(dictionary, detectorParams);
-    detector.detectMarkers(img, corners, markerIDs, rejected);
-
-    cv::Mat outputImage = im.clone();
-    // cv::aruco::drawDetectedMarkers(outputImage, corners, markerIDs);
+    detector_.detectMarkers(strip_, corners, markerIDs, rejected);
 
-    if (markerIDs.size() > 0) {
-        int count = 0;
-        for(const auto& corner : corners) {
-            cv::Point2f center(0.f, 0.f);
+    for (size_t count = 0; count < corners.size(); count++) {
+        cv::Point2f center(0.f, 0.f);
 
-            for(const auto& c : corner) {
-                center += c;
-            }
-            center /= 4.f;
-            if (center.x < 250) {
-                tray_aruco_id.at(0) = markerIDs[count];
-            } else if (center.x < 400) {
-                tray_aruco_id.at(1) = markerIDs[count];
-            } else {
-                tray_aruco_id.at(2) = markerIDs[count];
-            }
-            count += 1; 
-            // cv::circle(outputImage, center, 4, cv::Scalar(0,0,255), cv::FILLED);
+        for (const auto& c : corners[count]) {
+            center += c;
         }
+        center /= 4.f;
+        int slot = std::min(2, std::max(0, static_cast<int>(center.x) / kStripCell));
+        tray_aruco_id.at(slot) = markerIDs[count];
     }
-    
+
+    cached_stamp_ = stamp;
+    cached_ids_ = tray_aruco_id;
     return tray_aruco_id;
-}
\ No newline at end of file
+}
+
+std::vector<int> tray_detect(cv::Mat frame){
+    static TrayDetector detector;
+    return detector.detect(frame);
+}
@@ -0,0 +1,357 @@
+/**
+ * @copyright Copyright (c) 2023
+ * @file vision_benchmark.cpp
+ * @author Sanchit Kedia (sanchit@terpmail.umd.edu)
+ * @author Adarsh Malapaka (amalapak@terpmail.umd.edu)
+ * @author Tanmay Haldankar (tanmayh@terpmail.umd.edu)
+ * @author Sahruday Patti (sahruday@umd.edu)
+ * @author Kshitij Karnawat (kshitij@umd.edu)
+ * @brief Offline latency and accuracy benchmark of the vision functions for ARIAC 2023 (Group 3)
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ * Usage: vision_benchmark [--mode=default|production|all] <corpus_dir> [iterations] [warmup]
+ *
+ * The default mode times rightbin() and leftbin(), a sequential detector that classifies every
+ * slot of every frame. The production mode times the BinGridDetector configuration of the
+ * part_detector node, parallel over the bins and incremental, fed with the frames of each camera
+ * in file order as consecutive camera frames. All runs both, the other functions are timed in
+ * every mode.
+ *
+ * The corpus directory holds camera frames and a labels.yml ground truth file
+ * (cv::FileStorage format, image paths relative to the corpus directory):
+ *
+ *   %YAML:1.0
+ *   right_bins:
+ *      - { image: "right_bins_000.png", parts: [ [ 2, 11, 5 ], [ 0, 10, 14 ] ] }   # [color, type, quad]
+ *   left_bins:
+ *      - { image: "left_bins_000.png", parts: [ [ 4, 13, 40 ] ] }
+ *   conveyor:
+ *      - { image: "conveyor_000.png", parts: [ [ 1, 12 ] ] }                        # [color, type]
+ *   trays:
+ *      - { image: "kts1_000.png", ids: [ 3, -1, 7 ] }                               # Tray ID per slot
+ *
+ * etc/vision_corpus holds a small synthetic sample set drawn on the camera layouts of the detectors.
+ *
+ */
+#include <opencv2/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "part_type_detect.hpp"
+#include "bin_grid_detector.hpp"
+#include "tray_id_detect.hpp"
+
+namespace {
+
+/**
+ * @brief One recorded camera frame and its ground truth
+ *
+ */
+struct Sample {
+    cv::Mat image;
+    std::vector<std::vector<int>> parts;  // Bins: {color, type, quad}, conveyor: {color, type}
+    std::vector<int> ids;                 // Trays: tray ID per slot
+};
+
+/**
+ * @brief Latency and accuracy of one benchmarked function
+ *
+ */
+struct Result {
+    std::string name;
+    std::vector<double> latency_us;
+    int correct = 0;
+    int total = 0;
+};
+
+std::vector<Sample> load_samples(const cv::FileStorage& fs, const std::string& key, const std::string& dir) {
+    std::vector<Sample> samples;
+    cv::FileNode node = fs[key];
+    for (const auto& entry : node) {
+        Sample sample;
+        std::string path = dir + "/" + static_cast<std::string>(entry["image"]);
+        sample.image = cv::imread(path, cv::IMREAD_COLOR);
+        if (sample.image.empty()) {
+            std::fprintf(stderr, "Skipping unreadable image %s\n", path.c_str());
+            continue;
+        }
+        for (const auto& part : entry["parts"]) {
+            std::vector<int> values;
+            for (const auto& v : part) {
+                values.push_back(static_cast<int>(v));
+            }
+            sample.parts.push_back(values);
+        }
+        for (const auto& id : entry["ids"]) {
+            sample.ids.push_back(static_cast<int>(id));
+        }
+        samples.push_back(sample);
+    }
+    return samples;
+}
+
+/**
+ * @brief Time fn over all samples, warmup rounds are run but not recorded
+ *
+ */
+void time_samples(Result& result, const std::vector<Sample>& samples, int iterations, int warmup,
+                  const std::function<void(const Sample&)>& fn) {
+    for (int round = 0; round < warmup + iterations; round++) {
+        for (const auto& sample : samples) {
+            auto start = std::chrono::steady_clock::now();
+            fn(sample);
+            auto end = std::chrono::steady_clock::now();
+            if (round >= warmup) {
+                result.latency_us.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+            }
+        }
+    }
+}
+
+/**
+ * @brief Slot level accuracy of one bin camera frame, a slot is correct when color and type match
+ *
+ */
+void score_bins(Result& result, const std::vector<std::vector<int>>& truth, const std::vector<std::vector<int>>& detected) {
+    std::map<int, std::pair<int, int>> expected, found;
+    for (const auto& p : truth) {
+        expected[p[2]] = {p[0], p[1]};
+    }
+    for (const auto& p : detected) {
+        found[p[2]] = {p[0], p[1]};
+    }
+    std::map<int, bool> slots;
+    for (const auto& e : expected) {
+        slots[e.first] = true;
+    }
+    for (const auto& f : found) {
+        slots[f.first] = true;
+    }
+    for (const auto& s : slots) {
+        auto e = expected.find(s.first);
+        auto f = found.find(s.first);
+        result.total++;
+        if (e != expected.end() && f != found.end() && e->second == f->second) {
+            result.correct++;
+        }
+    }
+}
+
+/**
+ * @brief Parts found by a detection, in the {color, type, quad} form of rightbin() and leftbin()
+ *
+ */
+std::vector<std::vector<int>> slot_parts(const BinSlotDetections& slots) {
+    std::vector<std::vector<int>> parts;
+    for (int i = 0; i < BinSlotDetections::kMaxSlots; i++) {
+        if (slots.occupied & (uint64_t{1} << i)) {
+            parts.push_back({slots.part[i] % 10, slots.part[i] / 10, slots.first_quadrant + i});
+        }
+    }
+    return parts;
+}
+
+/**
+ * @brief Time and score a bin camera with the part_detector configuration, parallel and incremental
+ *
+ * Every round feeds the frames in file order to the same detector, as consecutive frames of the camera.
+ */
+Result production_bins(const std::string& name, const std::vector<BinLayout>& layout, const std::vector<Sample>& samples,
+                       int iterations, int warmup) {
+    Result result{name};
+    BinGridDetector grid(layout, true, true);
+    BinSlotDetections slots;
+    time_samples(result, samples, iterations, warmup, [&](const Sample& s) { grid.detect({s.image}, slots); });
+
+    BinGridDetector scored(layout, true, true);
+    for (const auto& s : samples) {
+        scored.detect({s.image}, slots);
+        score_bins(result, s.parts, slot_parts(slots));
+    }
+    return result;
+}
+
+/**
+ * @brief Run the bin detector on a frame and call fn for every part contour it classifies in a labelled slot
+ *
+ */
+void for_each_labelled_part(BinGridDetector& grid, const Sample& sample,
+                            const std::function<void(const cv::Mat&, const cv::Mat&, const std::vector<cv::Point>&, int)>& fn) {
+    std::map<int, int> truth_type;
+    for (const auto& p : sample.parts) {
+        truth_type[p[2]] = p[1];
+    }
+
+    grid.set_contour_callback([&](size_t, int quadrant, const cv::Mat& labels, const cv::Mat& mask,
+                                  const std::vector<cv::Point>& c) {
+        auto truth = truth_type.find(quadrant);
+        if (truth != truth_type.end()) {
+            fn(labels, mask, c, truth->second);
+        }
+    });
+    grid.detect(std::vector<cv::Mat>{sample.image});
+    grid.set_contour_callback(nullptr);
+}
+
+/**
+ * @brief Multiset match of the detected conveyor parts against the ground truth
+ *
+ */
+void score_conveyor(Result& result, const std::vector<std::vector<int>>& truth, const std::vector<std::vector<int>>& detected) {
+    std::vector<bool> used(detected.size(), false);
+    for (const auto& t : truth) {
+        result.total++;
+        for (size_t i = 0; i < detected.size(); i++) {
+            if (!used[i] && detected[i][0] == t[0] && detected[i][1] == t[1]) {
+                used[i] = true;
+                result.correct++;
+                break;
+            }
+        }
+    }
+    // Every extra detection is a false positive
+    for (bool u : used) {
+        if (!u) {
+            result.total++;
+        }
+    }
+}
+
+double percentile(std::vector<double> values, double p) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    size_t k = std::min(values.size() - 1, static_cast<size_t>(p / 100.0 * values.size()));
+    std::nth_element(values.begin(), values.begin() + k, values.end());
+    return values[k];
+}
+
+void print_result(const Result& r) {
+    double mean = 0.0;
+    for (double v : r.latency_us) {
+        mean += v;
+    }
+    mean = r.latency_us.empty() ? 0.0 : mean / r.latency_us.size();
+    std::string accuracy = r.total == 0 ? "-" : std::to_string(100.0 * r.correct / r.total).substr(0, 5) + "%";
+    std::printf("%-14s %8zu %10.1f %10.1f %10.1f %10.1f %9s (%d/%d)\n", r.name.c_str(), r.latency_us.size(),
+                mean, percentile(r.latency_us, 50), percentile(r.latency_us, 90), percentile(r.latency_us, 99),
+                accuracy.c_str(), r.correct, r.total);
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+    std::string mode = "all";
+    std::vector<std::string> args;
+    for (int i = 1; i < argc; i++) {
+        if (std::strncmp(argv[i], "--mode=", 7) == 0) {
+            mode = argv[i] + 7;
+        } else {
+            args.push_back(argv[i]);
+        }
+    }
+    if (args.empty() || (mode != "default" && mode != "production" && mode != "all")) {
+        std::fprintf(stderr, "Usage: %s [--mode=default|production|all] <corpus_dir> [iterations] [warmup]\n", argv[0]);
+        return 1;
+    }
+    std::string dir = args[0];
+    int iterations = args.size() > 1 ? std::atoi(args[1].c_str()) : 50;
+    int warmup = args.size() > 2 ? std::atoi(args[2].c_str()) : 5;
+    bool run_default = mode != "production";
+    bool run_production = mode != "default";
+
+    cv::FileStorage fs(dir + "/labels.yml", cv::FileStorage::READ);
+    if (!fs.isOpened()) {
+        std::fprintf(stderr, "Cannot open %s/labels.yml\n", dir.c_str());
+        return 1;
+    }
+    std::vector<Sample> right = load_samples(fs, "right_bins", dir);
+    std::vector<Sample> left = load_samples(fs, "left_bins", dir);
+    std::vector<Sample> conv = load_samples(fs, "conveyor", dir);
+    std::vector<Sample> trays = load_samples(fs, "trays", dir);
+
+    std::vector<Result> results;
+
+    if (run_default) {
+        Result r{"rightbin"};
+        time_samples(r, right, iterations, warmup, [](const Sample& s) { rightbin(s.image); });
+        for (const auto& s : right) {
+            score_bins(r, s.parts, rightbin(s.image));
+        }
+        results.push_back(r);
+
+        Result l{"leftbin"};
+        time_samples(l, left, iterations, warmup, [](const Sample& s) { leftbin(s.image); });
+        for (const auto& s : left) {
+            score_bins(l, s.parts, leftbin(s.image));
+        }
+        results.push_back(l);
+    }
+    if (run_production) {
+        results.push_back(production_bins("rightbin_prod", right_bins_layout(), right, iterations, warmup));
+        results.push_back(production_bins("leftbin_prod", left_bins_layout(), left, iterations, warmup));
+    }
+
+    // detect_type() is timed per part on the contours the bin detector classifies
+    Result t{"detect_type"};
+    BinGridDetector right_grid(right_bins_layout());
+    BinGridDetector left_grid(left_bins_layout());
+    for (int round = 0; round < warmup + iterations; round++) {
+        auto run = [&](BinGridDetector& grid, const std::vector<Sample>& samples) {
+            for (const auto& s : samples) {
+                for_each_labelled_part(grid, s, [&](const cv::Mat& labels, const cv::Mat& mask,
+                                                    const std::vector<cv::Point>& c, int type) {
+                    auto start = std::chrono::steady_clock::now();
+                    int detected = detect_type(labels, mask, c);
+                    auto end = std::chrono::steady_clock::now();
+                    if (round >= warmup) {
+                        t.latency_us.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+                    }
+                    if (round == warmup) {
+                        t.total++;
+                        t.correct += detected == type ? 1 : 0;
+                    }
+                });
+            }
+        };
+        run(right_grid, right);
+        run(left_grid, left);
+    }
+    results.push_back(t);
+
+    Result c{"conveyor"};
+    time_samples(c, conv, iterations, warmup, [](const Sample& s) { conveyor(s.image); });
+    for (const auto& s : conv) {
+        score_conveyor(c, s.parts, conveyor(s.image));
+    }
+    results.push_back(c);
+
+    Result k{"tray_detect"};
+    time_samples(k, trays, iterations, warmup, [](const Sample& s) { tray_detect(s.image); });
+    for (const auto& s : trays) {
+        std::vector<int> ids = tray_detect(s.image);
+        for (size_t i = 0; i < s.ids.size() && i < ids.size(); i++) {
+            k.total++;
+            k.correct += ids[i] == s.ids[i] ? 1 : 0;
+        }
+    }
+    results.push_back(k);
+
+    std::printf("%s mode, %d iterations after %d warmup rounds, latency in microseconds per call\n", mode.c_str(), iterations, warmup);
+    std::printf("%-14s %8s %10s %10s %10s %10s %9s\n", "function", "calls", "mean", "p50", "p90", "p99", "accuracy");
+    for (const auto& result : results) {
+        print_result(result);
+    }
+    return 0;
+}